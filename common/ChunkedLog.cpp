@@ -0,0 +1,263 @@
+#include "ChunkedLog.hpp"
+
+#include <zlib.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Packet;
+
+namespace ChunkedLog
+{
+
+static const char FileMagic[8] = {'R', 'J', 'L', 'O', 'G', 'C', 'H', 'K'};
+static const char TrailerMagic[8] = {'R', 'J', 'L', 'O', 'G', 'E', 'N', 'D'};
+static const uint32_t ChunkMagic = 0x4b4e4843;	// "CHNK"
+
+bool isChunked(const uint8_t *data, uint64_t size)
+{
+	return size >= sizeof(FileHeader) && memcmp(data, FileMagic, sizeof(FileMagic)) == 0;
+}
+
+// Returns true if a valid chunk starts at @offset
+static bool validChunk(const uint8_t *data, uint64_t size, uint64_t offset, ChunkHeader &header)
+{
+	if (offset + sizeof(header) > size)
+	{
+		return false;
+	}
+
+	memcpy(&header, data + offset, sizeof(header));
+	if (header.magic != ChunkMagic || offset + sizeof(header) + header.compressedSize > size)
+	{
+		return false;
+	}
+
+	return crc32(0, data + offset + sizeof(header), header.compressedSize) == header.crc;
+}
+
+bool readIndex(const uint8_t *data, uint64_t size, vector<IndexEntry> &index, bool *recovered)
+{
+	index.clear();
+	if (recovered)
+	{
+		*recovered = false;
+	}
+
+	if (!isChunked(data, size))
+	{
+		return false;
+	}
+
+	// Use the index at the end of the file if it is intact
+	if (size >= sizeof(FileHeader) + sizeof(Trailer))
+	{
+		Trailer trailer;
+		memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+		if (memcmp(trailer.magic, TrailerMagic, sizeof(TrailerMagic)) == 0 &&
+			trailer.indexOffset + trailer.numChunks * sizeof(IndexEntry) + sizeof(trailer) == size)
+		{
+			index.resize(trailer.numChunks);
+			if (trailer.numChunks)
+			{
+				memcpy(&index[0], data + trailer.indexOffset, trailer.numChunks * sizeof(IndexEntry));
+			}
+			return true;
+		}
+	}
+
+	// No usable index: find chunks by scanning
+	if (recovered)
+	{
+		*recovered = true;
+	}
+
+	uint64_t offset = sizeof(FileHeader);
+	ChunkHeader header;
+	while (validChunk(data, size, offset, header))
+	{
+		IndexEntry entry;
+		entry.offset = offset;
+		entry.firstTime = header.firstTime;
+		entry.lastTime = header.lastTime;
+		entry.numFrames = header.numFrames;
+		entry.reserved = 0;
+		index.push_back(entry);
+
+		offset += sizeof(header) + header.compressedSize;
+	}
+
+	return true;
+}
+
+bool readChunk(const uint8_t *data, uint64_t size, const IndexEntry &entry, string &raw)
+{
+	ChunkHeader header;
+	if (!validChunk(data, size, entry.offset, header))
+	{
+		return false;
+	}
+
+	raw.resize(header.rawSize);
+	uLongf rawSize = header.rawSize;
+	if (uncompress((Bytef *)&raw[0], &rawSize, data + entry.offset + sizeof(header), header.compressedSize) != Z_OK ||
+		rawSize != header.rawSize)
+	{
+		raw.clear();
+		return false;
+	}
+
+	return true;
+}
+
+Writer::Writer(size_t chunkBytes, int chunkFrames)
+{
+	_fd = -1;
+	_offset = 0;
+	_chunkBytes = chunkBytes;
+	_chunkFrames = chunkFrames;
+	_numFrames = 0;
+	_firstTime = 0;
+	_lastTime = 0;
+}
+
+bool Writer::open(int fd)
+{
+	_fd = fd;
+	_offset = 0;
+	_raw.clear();
+	_numFrames = 0;
+	_index.clear();
+
+	FileHeader header;
+	memcpy(header.magic, FileMagic, sizeof(FileMagic));
+	header.version = Version;
+	header.reserved = 0;
+	return write(&header, sizeof(header));
+}
+
+bool Writer::addFrame(const LogFrame &frame)
+{
+	if (!_numFrames)
+	{
+		_firstTime = frame.command_time();
+	}
+	_lastTime = frame.command_time();
+	++_numFrames;
+
+	// Only reads the cached sizes, so another thread may serialize the same frame at the same time
+	uint32_t size = frame.GetCachedSize();
+	size_t start = _raw.size();
+	_raw.resize(start + sizeof(size) + size);
+	memcpy(&_raw[start], &size, sizeof(size));
+	frame.SerializeWithCachedSizesToArray((uint8_t *)&_raw[start + sizeof(size)]);
+
+	if (_raw.size() >= _chunkBytes || _numFrames >= _chunkFrames)
+	{
+		return flush();
+	}
+
+	return true;
+}
+
+bool Writer::flush()
+{
+	if (!_numFrames)
+	{
+		return true;
+	}
+
+	// Compress after space for the header so the header and data can go in one write
+	// without moving the data.  A crash is less likely to tear the chunk.
+	uLongf compressedSize = compressBound(_raw.size());
+	_compressed.resize(sizeof(ChunkHeader) + compressedSize);
+	Bytef *data = (Bytef *)&_compressed[sizeof(ChunkHeader)];
+	if (compress2(data, &compressedSize, (const Bytef *)_raw.data(), _raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		return false;
+	}
+
+	ChunkHeader header;
+	header.magic = ChunkMagic;
+	header.compressedSize = compressedSize;
+	header.rawSize = _raw.size();
+	header.numFrames = _numFrames;
+	header.firstTime = _firstTime;
+	header.lastTime = _lastTime;
+	header.crc = crc32(0, data, compressedSize);
+	header.reserved = 0;
+
+	IndexEntry entry;
+	entry.offset = _offset;
+	entry.firstTime = _firstTime;
+	entry.lastTime = _lastTime;
+	entry.numFrames = _numFrames;
+	entry.reserved = 0;
+
+	_raw.clear();
+	_numFrames = 0;
+
+	memcpy(&_compressed[0], &header, sizeof(header));
+	if (!write(_compressed.data(), sizeof(header) + compressedSize))
+	{
+		return false;
+	}
+
+	_index.push_back(entry);
+	return true;
+}
+
+bool Writer::close()
+{
+	if (_fd < 0)
+	{
+		return false;
+	}
+
+	bool ok = flush();
+
+	Trailer trailer;
+	trailer.indexOffset = _offset;
+	trailer.numChunks = _index.size();
+	memcpy(trailer.magic, TrailerMagic, sizeof(TrailerMagic));
+
+	ok = ok && (_index.empty() || write(&_index[0], _index.size() * sizeof(IndexEntry)));
+	ok = ok && write(&trailer, sizeof(trailer));
+
+	_fd = -1;
+	return ok;
+}
+
+void Writer::abandon()
+{
+	_fd = -1;
+	_raw.clear();
+	_numFrames = 0;
+	_index.clear();
+}
+
+bool Writer::write(const void *data, size_t size)
+{
+	const char *p = (const char *)data;
+	while (size)
+	{
+		ssize_t n = ::write(_fd, p, size);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+
+		p += n;
+		size -= n;
+		_offset += n;
+	}
+
+	return true;
+}
+
+}
@@ -0,0 +1,145 @@
+// Chunked, compressed log file format.
+//
+// File layout:
+//   FileHeader
+//   Chunks: each is a ChunkHeader followed by ChunkHeader::compressedSize bytes of zlib data
+//   Index: one IndexEntry per chunk
+//   Trailer
+//
+// The uncompressed contents of a chunk are records in the original log format:
+// a uint32_t size followed by a serialized LogFrame.
+//
+// A log that was not closed cleanly has no index or trailer.  Readers recover by scanning
+// chunk headers from the start of the file and stop at the first incomplete or corrupt chunk,
+// so only the frames that had not yet been written in the last chunk are lost.
+//
+// All integers are stored in host (little-endian) byte order.
+
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+namespace ChunkedLog
+{
+	static const uint32_t Version = 1;
+
+	// Default limits on the uncompressed size of a chunk.
+	// A chunk is written when either is reached.
+	static const size_t DefaultChunkBytes = 1024 * 1024;
+	static const int DefaultChunkFrames = 300;
+
+	struct FileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t reserved;
+	};
+
+	struct ChunkHeader
+	{
+		uint32_t magic;
+		uint32_t compressedSize;
+		uint32_t rawSize;
+		uint32_t numFrames;
+
+		/// command_time of the first and last frames in the chunk
+		uint64_t firstTime;
+		uint64_t lastTime;
+
+		/// CRC32 of the compressed data
+		uint32_t crc;
+		uint32_t reserved;
+	};
+
+	struct IndexEntry
+	{
+		/// File offset of the ChunkHeader
+		uint64_t offset;
+		uint64_t firstTime;
+		uint64_t lastTime;
+		uint32_t numFrames;
+		uint32_t reserved;
+	};
+
+	struct Trailer
+	{
+		/// File offset of the first IndexEntry
+		uint64_t indexOffset;
+		uint64_t numChunks;
+		char magic[8];
+	};
+
+	/// Returns true if @data starts with a chunked log FileHeader
+	bool isChunked(const uint8_t *data, uint64_t size);
+
+	/// Finds the chunks in a chunked log.
+	/// The index at the end of the file is used if it is intact.  Otherwise the chunks are
+	/// found by scanning and @recovered (if not null) is set to true.
+	/// Returns false if @data is not a chunked log.
+	bool readIndex(const uint8_t *data, uint64_t size, std::vector<IndexEntry> &index, bool *recovered = 0);
+
+	/// Decompresses the chunk described by @entry into @raw.
+	/// Returns false if the chunk is corrupt.
+	bool readChunk(const uint8_t *data, uint64_t size, const IndexEntry &entry, std::string &raw);
+
+	/// Writes a chunked log to a file descriptor.
+	/// The file descriptor is not closed by the writer.
+	class Writer
+	{
+		public:
+			Writer(size_t chunkBytes = DefaultChunkBytes, int chunkFrames = DefaultChunkFrames);
+
+			/// Starts a new log on @fd, which must be an empty file.
+			/// Returns false if the header can't be written.
+			bool open(int fd);
+
+			/// Adds a frame, writing a chunk if this fills it.
+			/// The frame's sizes must already be cached by calling ByteSize() on it.
+			/// Returns false on a write error.
+			bool addFrame(const Packet::LogFrame &frame);
+
+			/// Writes any buffered frames as a chunk
+			bool flush();
+
+			/// Flushes and writes the index and trailer.
+			/// The log can't be written to after this.
+			bool close();
+
+			/// Forgets the log without writing anything more, e.g. after a write error.
+			/// The log can be recovered by scanning up to the last complete chunk.
+			void abandon();
+
+			bool isOpen() const
+			{
+				return _fd >= 0;
+			}
+
+			/// Total bytes written to the file
+			uint64_t bytesWritten() const
+			{
+				return _offset;
+			}
+
+		private:
+			bool write(const void *data, size_t size);
+
+			int _fd;
+			uint64_t _offset;
+
+			size_t _chunkBytes;
+			int _chunkFrames;
+
+			// Records for the chunk being built
+			std::string _raw;
+			std::string _compressed;
+			int _numFrames;
+			uint64_t _firstTime;
+			uint64_t _lastTime;
+
+			std::vector<IndexEntry> _index;
+	};
+}
@@ -17,6 +17,13 @@ const float Ball_Diameter = 0.043f;
 const float Ball_Radius = Ball_Diameter/2.0f;
 const float Ball_Mass = 0.048f;
 
+/** Deceleration of the ball from friction (coefficient times gravity) while rolling and while sliding, in m/s^2 */
+const float Ball_RollingDecel = 0.04148f * 9.81f;
+const float Ball_SlidingDecel = 0.3f * 9.81f;
+
+/** A kicked ball slides until it slows to this fraction of its initial speed, then rolls */
+const float Ball_RollingSpeedFraction = 5.0f / 7.0f;
+
 const float Field_Length = 6.5f;
 const float Field_Width = 4.455f;
 const float Field_Border = 0.25f;
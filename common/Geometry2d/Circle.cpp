@@ -185,3 +185,11 @@ bool Circle::hit(const Geometry2d::Segment &seg) const
 {
     return seg.nearPoint(center, radius() + Robot_Radius);
 }
+
+bool Circle::hitBounds(Point &min, Point &max) const
+{
+    const float r = radius() + Robot_Radius;
+    min = center - Point(r, r);
+    max = center + Point(r, r);
+    return true;
+}
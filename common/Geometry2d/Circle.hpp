@@ -18,13 +18,12 @@ namespace Geometry2d
         Circle(const Point &c, float r)
         {
             center = c;
-            _r = r;
-            _rsq = -1;
+            radius(r);
         }
 
         Circle(const Circle &other) {
             center = other.center;
-            _r = other.radius();
+            radius(other.radius());
         }
 
         Shape *clone() const;
@@ -32,7 +31,9 @@ namespace Geometry2d
 
         // Both radius and radius-squared are stored, since some operations are more
         // efficient with one or the other.
-        // As long as one is specified, the other is calculated lazily.
+        // Setting the radius stores both, so reading a circle never writes to it and
+        // obstacles can be shared between planning threads.
+        // If only the radius squared is given, the radius is calculated lazily.
         
         // Radius squared
         float radius_sq() const
@@ -65,7 +66,7 @@ namespace Geometry2d
         void radius(float value)
         {
             _r = value;
-            _rsq = -1;
+            _rsq = (value >= 0) ? value * value : -1;
         }
         
         bool containsPoint(const Point &pt) const;
@@ -73,6 +74,8 @@ namespace Geometry2d
         bool hit(const Point &pt) const;
 
         bool hit(const Segment &pt) const;
+
+        bool hitBounds(Point &min, Point &max) const;
         
         // Returns the number of points at which this circle intersects the given circle.
         // i must be null or point to two points.
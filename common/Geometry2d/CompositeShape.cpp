@@ -1,5 +1,8 @@
 #include "CompositeShape.hpp"
 
+#include <cmath>
+#include <limits>
+
 using namespace Geometry2d;
 
 
@@ -14,18 +17,54 @@ bool Geometry2d::CompositeShape::containsPoint(const Point &pt) const {
     return false;
 }
 
+bool Geometry2d::CompositeShape::hitBounds(Point &min, Point &max) const {
+    if (_subshapes.empty()) {
+        return false;
+    }
+
+    Bounds all = _bounds[0];
+    for (const Bounds &b : _bounds) {
+        all.minx = std::min(all.minx, b.minx);
+        all.miny = std::min(all.miny, b.miny);
+        all.maxx = std::max(all.maxx, b.maxx);
+        all.maxy = std::max(all.maxy, b.maxy);
+    }
+
+    if (std::isinf(all.minx) || std::isinf(all.miny) || std::isinf(all.maxx) || std::isinf(all.maxy)) {
+        return false;
+    }
+
+    min = Point(all.minx, all.miny);
+    max = Point(all.maxx, all.maxy);
+    return true;
+}
+
+Geometry2d::CompositeShape::Bounds Geometry2d::CompositeShape::bounds(const Shape &shape) {
+    Point min, max;
+    if (shape.hitBounds(min, max)) {
+        Bounds b = {min.x, min.y, max.x, max.y};
+        return b;
+    }
+
+    const float inf = std::numeric_limits<float>::infinity();
+    Bounds b = {-inf, -inf, inf, inf};
+    return b;
+}
+
 void Geometry2d::CompositeShape::add(std::shared_ptr<Shape> shape) {
     if (shape) {
         _subshapes.push_back(shape);
+        _bounds.push_back(bounds(*shape));
     }
 }
 
 void Geometry2d::CompositeShape::add(const CompositeShape &compShape) {
-    for (auto shape : compShape.subshapes()) {
-        add(shape);
-    }
+    // The boxes are already known, so just copy them
+    _subshapes.insert(_subshapes.end(), compShape._subshapes.begin(), compShape._subshapes.end());
+    _bounds.insert(_bounds.end(), compShape._bounds.begin(), compShape._bounds.end());
 }
 
 void Geometry2d::CompositeShape::clear() {
     _subshapes.clear();
+    _bounds.clear();
 }
@@ -5,7 +5,9 @@
 #include "Segment.hpp"
 #include <vector>
 #include <memory>
-#include <set>
+#include <bitset>
+#include <algorithm>
+#include <stdint.h>
 
 class Obstacle;
 
@@ -13,11 +15,15 @@ namespace Geometry2d {
 
     /**
      * A Geometry2d::CompositeShape is a Shape that is made up of other shapes.
+     *
+     * Each subshape's hitBounds() box is cached when it is added, and hit() only runs
+     * the exact test on subshapes whose box overlaps the object being tested.
+     * Because of this, subshapes must not be moved or resized after they are added.
      */
     class CompositeShape : public Shape {
     public:
         CompositeShape(const std::shared_ptr<Shape> shape) {
-            _subshapes.push_back(shape);
+            add(shape);
         }
 
         CompositeShape() {}
@@ -28,7 +34,7 @@ namespace Geometry2d {
 
         CompositeShape(const CompositeShape &other) {
             for (auto itr : other) {
-                _subshapes.push_back(std::shared_ptr<Shape>((*itr).clone()));
+                add(std::shared_ptr<Shape>((*itr).clone()));
             }
         }
 
@@ -36,6 +42,10 @@ namespace Geometry2d {
 
         virtual bool containsPoint(const Point &pt) const;
 
+        /// The union of the subshapes' boxes.
+        /// Returns false if any subshape doesn't have one.
+        bool hitBounds(Point &min, Point &max) const;
+
         void add(const std::shared_ptr<Shape> shape);
 
         /// adds @compShape's subshapes to the receiver
@@ -57,35 +67,109 @@ namespace Geometry2d {
         }
 
 
+        /**
+         * A set of subshapes, where bit i corresponds to subshapes()[i].
+         *
+         * The first InlineSize bits are stored in the set itself, so the usual number of
+         * obstacles never allocates.  Bits past that are kept in a vector that only grows
+         * if a subshape past InlineSize is hit.
+         */
+        class HitSet {
+        public:
+            static const size_t InlineSize = 128;
+
+            void set(size_t i) {
+                if (i < InlineSize) {
+                    _bits.set(i);
+                } else {
+                    i -= InlineSize;
+                    if (_overflow.size() <= i / 64) {
+                        _overflow.resize(i / 64 + 1, 0);
+                    }
+                    _overflow[i / 64] |= uint64_t(1) << (i % 64);
+                }
+            }
+
+            bool test(size_t i) const {
+                if (i < InlineSize) {
+                    return _bits.test(i);
+                }
+
+                i -= InlineSize;
+                return i / 64 < _overflow.size() && (_overflow[i / 64] >> (i % 64) & 1);
+            }
+
+            bool any() const {
+                if (_bits.any()) {
+                    return true;
+                }
+                for (uint64_t word : _overflow) {
+                    if (word) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool none() const {
+                return !any();
+            }
+
+            /// Returns true if this contains any subshape that isn't in @other
+            bool hasAnyNotIn(const HitSet &other) const {
+                if ((_bits & ~other._bits).any()) {
+                    return true;
+                }
+                for (size_t w = 0; w < _overflow.size(); ++w) {
+                    uint64_t otherWord = w < other._overflow.size() ? other._overflow[w] : 0;
+                    if (_overflow[w] & ~otherWord) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            std::bitset<InlineSize> _bits;
+            std::vector<uint64_t> _overflow;
+        };
+
         /**
          * Checks if a given object hits obstacles in the group
          *
          * @param obj The object to collision test
-         * @param hitSet A set to add the colliding obstacles to
+         * @param hitSet A set to add the indices of the colliding obstacles to
          * @return A bool telling whether or not there were any collisions
          */
         template<typename T>
-        bool hit(const T &obj, std::set<std::shared_ptr<Shape> > &hitSet) const
+        bool hit(const T &obj, HitSet &hitSet) const
         {
-            for (const_iterator it = begin(); it != end(); ++it)
+            const Bounds query = bounds(obj);
+            const size_t n = _subshapes.size();
+            for (size_t i = 0; i < n; ++i)
             {
-                if ((*it)->hit(obj))
+                if (_bounds[i].overlaps(query) && _subshapes[i]->hit(obj))
                 {
-                    hitSet.insert(*it);
+                    hitSet.set(i);
                 }
             }
 
-            return !hitSet.empty();
+            return hitSet.any();
         }
 
-        bool hit(const Point &pt, std::set<std::shared_ptr<Shape> > &hitSet) const {
+        bool hit(const Point &pt, HitSet &hitSet) const {
             return hit<Point>(pt, hitSet);
         }
 
-        bool hit(const Segment &seg, std::set<std::shared_ptr<Shape> > &hitSet) const {
+        bool hit(const Segment &seg, HitSet &hitSet) const {
             return hit<Segment>(seg, hitSet);
         }
 
+        /// Returns true if @newHits contains any obstacles that aren't in @oldHits
+        static bool hitsNewObstacle(const HitSet &newHits, const HitSet &oldHits) {
+            return newHits.hasAnyNotIn(oldHits);
+        }
+
         /**
          * Checks if a given shape is in it
          *
@@ -95,9 +179,11 @@ namespace Geometry2d {
         template<typename T>
         bool hit(const T &obj) const
         {
-            for (const_iterator it = begin(); it!=end(); ++it)
+            const Bounds query = bounds(obj);
+            const size_t n = _subshapes.size();
+            for (size_t i = 0; i < n; ++i)
             {
-                if ((*it)->hit(obj))
+                if (_bounds[i].overlaps(query) && _subshapes[i]->hit(obj))
                 {
                     return true;
                 }
@@ -121,12 +207,10 @@ namespace Geometry2d {
         typedef std::shared_ptr<Shape> value_type;
         
         // STL Interface
+        // Only const iteration is allowed, since replacing a subshape would leave its cached box behind
         const_iterator begin() const { return _subshapes.begin(); }
         const_iterator end() const { return _subshapes.end(); }
 
-        iterator begin() { return _subshapes.begin(); }
-        iterator end() { return _subshapes.end(); }
-
         std::string toString() {
             std::stringstream str;
             str << "Composite<";
@@ -149,6 +233,35 @@ namespace Geometry2d {
 
 
     private:
+        /// Axis-aligned box used to skip exact collision tests
+        struct Bounds {
+            float minx, miny, maxx, maxy;
+
+            bool overlaps(const Bounds &other) const {
+                return minx <= other.maxx && other.minx <= maxx &&
+                       miny <= other.maxy && other.miny <= maxy;
+            }
+        };
+
+        static Bounds bounds(const Point &pt) {
+            Bounds b = {pt.x, pt.y, pt.x, pt.y};
+            return b;
+        }
+
+        static Bounds bounds(const Segment &seg) {
+            Bounds b = {
+                std::min(seg.pt[0].x, seg.pt[1].x), std::min(seg.pt[0].y, seg.pt[1].y),
+                std::max(seg.pt[0].x, seg.pt[1].x), std::max(seg.pt[0].y, seg.pt[1].y)
+            };
+            return b;
+        }
+
+        /// Bounds of a subshape, or an infinite box if it doesn't have one
+        static Bounds bounds(const Shape &shape);
+
         std::vector<std::shared_ptr<Shape> > _subshapes;
+
+        /// _bounds[i] is the hitBounds() box of _subshapes[i], cached when it was added
+        std::vector<Bounds> _bounds;
     };
 }
@@ -188,3 +188,16 @@ bool Polygon::hit(const Segment &seg) const
 {
     return nearSegment(seg, Robot_Radius);
 }
+
+bool Polygon::hitBounds(Point &min, Point &max) const
+{
+    if (vertices.empty())
+    {
+        return false;
+    }
+    
+    Rect box = bbox();
+    min = Point(box.minx() - Robot_Radius, box.miny() - Robot_Radius);
+    max = Point(box.maxx() + Robot_Radius, box.maxy() + Robot_Radius);
+    return true;
+}
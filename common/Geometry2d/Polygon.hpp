@@ -41,6 +41,8 @@ namespace Geometry2d
 
         bool hit(const Geometry2d::Point &pt) const;
         bool hit(const Geometry2d::Segment &seg) const;
+
+        bool hitBounds(Point &min, Point &max) const;
         
         /// Returns true if this polygon contains any vertex of other.
         bool containsVertex(const Polygon &other) const;
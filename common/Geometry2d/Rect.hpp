@@ -81,6 +81,12 @@ namespace Geometry2d
 
 	        bool hit(const Segment &seg) const;
 
+	        bool hitBounds(Point &min, Point &max) const {
+	        	min = Point(minx(), miny());
+	        	max = Point(maxx(), maxy());
+	        	return true;
+	        }
+
 			Point center() const { return (pt[0] + pt[1]) / 2; }
 
 			void expand(const Point &pt);
@@ -44,6 +44,13 @@ namespace Geometry2d {
             return false;
         }
 
+        /// Finds an axis-aligned box outside of which hit() is always false.
+        /// This is used to skip the exact collision tests for shapes that are far away.
+        /// Returns false if the shape can't give a box, in which case it is always tested exactly.
+        virtual bool hitBounds(Point &min, Point &max) const {
+            return false;
+        }
+
         virtual std::string toString() {
             std::stringstream str;
             str << "Shape";
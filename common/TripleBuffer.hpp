@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * Passes the latest value of something from one writer thread to one reader thread
+ * without either of them ever waiting for the other.
+ *
+ * There are three copies of the value.  The writer fills the back buffer and publish() swaps it
+ * with the middle buffer.  read() swaps the middle buffer with the front buffer if something
+ * new was published and returns the front buffer.  Each buffer belongs to only one thread
+ * at a time, so T may be any copyable type (e.g. it may hold shared_ptrs).
+ *
+ * The reader sees the most recently published value, but may skip values if the writer
+ * publishes more than once between reads.
+ */
+template<typename T>
+class TripleBuffer
+{
+	public:
+		TripleBuffer(): _middle(1), _back(0), _front(2)
+		{
+		}
+
+		/// The buffer for the writer to fill.  Only call from the writer thread.
+		T &back()
+		{
+			return _buffers[_back];
+		}
+
+		/// Makes the back buffer available to the reader.  Only call from the writer thread.
+		/// The new back buffer holds an older value, so every field must be set again before publishing.
+		void publish()
+		{
+			_back = _middle.exchange(_back | Fresh, std::memory_order_acq_rel) & IndexMask;
+		}
+
+		/// Returns the most recently published value.  Only call from the reader thread.
+		/// The reference is valid until the next call.
+		const T &read()
+		{
+			if (_middle.load(std::memory_order_relaxed) & Fresh)
+			{
+				_front = _middle.exchange(_front, std::memory_order_acq_rel) & IndexMask;
+			}
+			return _buffers[_front];
+		}
+
+	private:
+		// _middle holds the index of the middle buffer and a flag that is set when
+		// the writer has published a buffer the reader hasn't seen
+		static const unsigned int IndexMask = 3;
+		static const unsigned int Fresh = 4;
+
+		T _buffers[3];
+		std::atomic<unsigned int> _middle;
+
+		unsigned int _back;
+		unsigned int _front;
+};
@@ -4,6 +4,8 @@
 
 using namespace std;
 
+TimeSource *currentTimeSource = 0;
+
 #ifdef __GNUC__
 // This function uses type_info::name which returns an implementation-dependent string.
 // This implementation expects gcc's convention as of 4.3.3:
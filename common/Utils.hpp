@@ -3,7 +3,9 @@
 
 #include <math.h>
 #include <sys/time.h>
+#include <time.h>
 #include <stdint.h>
+#include <atomic>
 #include <deque>
 #include <vector>
 #include <stdexcept>
@@ -93,8 +95,8 @@ float clamp(T value, T min, T max)
 	return value;
 }
 
-/** returns the local system timestamp */
-static inline uint64_t timestamp()
+/** returns the wall-clock time in microseconds, ignoring any installed TimeSource */
+static inline uint64_t systemTimestamp()
 {
 	struct timeval time;
 	gettimeofday(&time, 0);
@@ -102,6 +104,101 @@ static inline uint64_t timestamp()
 	return (uint64_t)time.tv_sec * 1000000 + (uint64_t)time.tv_usec;
 }
 
+/**
+ * Source of time for timestamp().
+ * By default timestamp() reads the system clock.  Installing a different source
+ * (see SimulatedClock) lets the whole program run on simulated time.
+ */
+class TimeSource
+{
+public:
+	virtual ~TimeSource() {}
+
+	/// Current time in microseconds
+	virtual uint64_t now() const = 0;
+};
+
+/**
+ * A clock that only moves when told to.
+ * Used to step soccer in lockstep with the simulator.
+ */
+class SimulatedClock: public TimeSource
+{
+public:
+	SimulatedClock(uint64_t start = 0): _now(start) {}
+
+	virtual uint64_t now() const
+	{
+		return _now;
+	}
+
+	void set(uint64_t t)
+	{
+		_now = t;
+	}
+
+	void advance(uint64_t dt)
+	{
+		_now += dt;
+	}
+
+private:
+	std::atomic<uint64_t> _now;
+};
+
+/// The installed TimeSource, or null for the system clock.  Use setTimeSource() to change it.
+extern TimeSource *currentTimeSource;
+
+/// Installs a time source for timestamp().  Pass null to go back to the system clock.
+/// This should be done before any threads that read the time are started.
+static inline void setTimeSource(TimeSource *source)
+{
+	currentTimeSource = source;
+}
+
+/** returns the local system timestamp, or simulated time if a TimeSource is installed */
+static inline uint64_t timestamp()
+{
+	return currentTimeSource ? currentTimeSource->now() : systemTimestamp();
+}
+
+/**
+ * Adds the time spent in its scope to a counter, in microseconds.
+ * Uses a monotonic clock, so it measures real time even when timestamp() is simulated.
+ *
+ * Example:
+ *	uint32_t planning = 0;
+ *	{
+ *		ScopedTimer t(planning);
+ *		...
+ *	}
+ */
+class ScopedTimer
+{
+public:
+	ScopedTimer(uint32_t &elapsed): _elapsed(elapsed)
+	{
+		_start = now();
+	}
+
+	~ScopedTimer()
+	{
+		_elapsed += now() - _start;
+	}
+
+	/// Monotonic time in microseconds
+	static uint64_t now()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+
+private:
+	uint32_t &_elapsed;
+	uint64_t _start;
+};
+
 // Removes all entries in a std::map which associate to the given value.
 template<class Map_Type, class Data_Type>
 void map_remove(Map_Type &map, Data_Type &value)
@@ -192,34 +289,6 @@ protected:
 	Coeffs _coeffs;
 };
 
-// An output iterator which throws an exception when it's used.
-// This is used for example to determine if the output of set_difference would be non-empty without
-// calculating all of it.
-template<typename T>
-class ExceptionIterator: public std::iterator<std::output_iterator_tag, void, void, void, void>
-{
-public:
-	ExceptionIterator &operator=(const T &value)
-	{
-		throw std::exception();
-	}
-
-	ExceptionIterator &operator*()
-	{
-		return *this;
-	}
-
-	ExceptionIterator &operator++()
-				{
-		return *this;
-				}
-
-	ExceptionIterator &operator++(int)
-				{
-		return *this;
-				}
-};
-
 // Sets str to the name of a class.
 // Use it like this:
 //		Object *obj = new Object();
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <fcntl.h>
 #include <protobuf/LogFrame.pb.h>
+#include <ChunkedLog.hpp>
 #include <git_version.h>
 #include <unistd.h>
 
@@ -16,16 +17,10 @@ const uint8_t vision_port[] = {0x27, 0x12};			// 10002
 
 const unsigned int FramePeriod = 1000000 / 60;
 
-bool writeFrame(int fd, const LogFrame &frame)
+bool writeFrame(ChunkedLog::Writer &log, const LogFrame &frame)
 {
-	uint32_t size = frame.ByteSize();
-	if (write(fd, &size, sizeof(size)) != sizeof(size))
-	{
-		printf("Failed to write size: %m\n");
-		return false;
-	}
-	
-	if (!frame.SerializePartialToFileDescriptor(fd))
+	frame.ByteSize();
+	if (!log.addFrame(frame))
 	{
 		printf("Failed to write packet: %m\n");
 		return false;
@@ -59,6 +54,15 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 	
+	ChunkedLog::Writer log;
+	if (!log.open(out_fd))
+	{
+		printf("Can't write to %s: %m\n", argv[2]);
+		close(out_fd);
+		pcap_close(pcap);
+		return 1;
+	}
+	
 	LogFrame frame;
 	bool needWrite = false;
 	
@@ -122,7 +126,7 @@ int main(int argc, char *argv[])
 			
 			// Write this frame
 			needWrite = false;
-			if (!writeFrame(out_fd, frame))
+			if (!writeFrame(log, frame))
 			{
 				break;
 			}
@@ -151,9 +155,13 @@ int main(int argc, char *argv[])
 	
 	if (needWrite)
 	{
-		writeFrame(out_fd, frame);
+		writeFrame(log, frame);
 	}
 	
+	if (!log.close())
+	{
+		printf("Failed to finish log: %m\n");
+	}
 	close(out_fd);
 	pcap_close(pcap);
 	
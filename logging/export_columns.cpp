@@ -0,0 +1,344 @@
+// Exports the world state and commands from a soccer log as columnar arrays for bulk analysis.
+//
+// Each column is written to <output dir>/<name>.<type> as raw little-endian values with a
+// fixed number of values per frame, so a column can be loaded directly, e.g. with numpy:
+//   np.fromfile('self_x.f32', dtype=np.float32).reshape(-1, 16)
+//
+// Per-robot columns have one value per shell number.  Missing values are NaN for
+// floating-point columns and zero for integer columns.
+// columns.txt lists every column as "<name> <type> <values per frame>" after the number of frames.
+//
+// Frames are read in batches and decoded by several threads, each filling its own rows of the batch.
+
+#include <LogReader.hpp>
+#include <Constants.hpp>
+
+#include <QDir>
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <limits>
+#include <stdio.h>
+#include <stdint.h>
+
+using namespace std;
+using namespace Packet;
+
+// Frames decoded at once
+static const int BatchSize = 4096;
+
+class ColumnBase
+{
+	public:
+		ColumnBase(const char *name, const char *type, int width):
+			name(name), type(type), width(width), _fp(0)
+		{
+		}
+
+		virtual ~ColumnBase()
+		{
+			if (_fp)
+			{
+				fclose(_fp);
+			}
+		}
+
+		bool open(const QString &dir)
+		{
+			QString filename = dir + "/" + name + "." + type;
+			_fp = fopen(filename.toAscii(), "wb");
+			if (!_fp)
+			{
+				printf("Can't create %s: %m\n", (const char *)filename.toAscii());
+			}
+			return _fp != 0;
+		}
+
+		/// Prepares @rows rows, all set to the missing value
+		virtual void reset(int rows) = 0;
+
+		/// Writes the first @rows rows
+		virtual bool write(int rows) = 0;
+
+		const char *name;
+		const char *type;
+		int width;
+
+	protected:
+		FILE *_fp;
+};
+
+template<typename T>
+class Column: public ColumnBase
+{
+	public:
+		Column(vector<ColumnBase *> &all, const char *name, const char *type, int width = 1):
+			ColumnBase(name, type, width)
+		{
+			all.push_back(this);
+		}
+
+		T &operator()(int row, int i = 0)
+		{
+			return _data[row * width + i];
+		}
+
+		virtual void reset(int rows)
+		{
+			_data.assign(rows * width, missing());
+		}
+
+		virtual bool write(int rows)
+		{
+			return fwrite(&_data[0], sizeof(T) * width, rows, _fp) == (size_t)rows;
+		}
+
+	private:
+		static T missing()
+		{
+			return numeric_limits<T>::has_quiet_NaN ? numeric_limits<T>::quiet_NaN() : T();
+		}
+
+		vector<T> _data;
+};
+
+/// All exported columns
+class Columns
+{
+	public:
+		vector<ColumnBase *> all;
+
+		Column<uint64_t> commandTime{all, "command_time", "u64"};
+		Column<uint8_t> blueTeam{all, "blue_team", "u8"};
+		Column<uint8_t> rawVisionPackets{all, "raw_vision_packets", "u8"};
+		Column<uint32_t> visionToRadioLatency{all, "vision_to_radio_latency", "u32"};
+
+		Column<uint32_t> timeVision{all, "time_vision", "u32"};
+		Column<uint32_t> timeModels{all, "time_models", "u32"};
+		Column<uint32_t> timeReferee{all, "time_referee", "u32"};
+		Column<uint32_t> timeGameplayPython{all, "time_gameplay_python", "u32"};
+		Column<uint32_t> timeGameplayPlanning{all, "time_gameplay_planning", "u32"};
+		Column<uint32_t> timeMotionControl{all, "time_motion_control", "u32"};
+		Column<uint32_t> timeLogging{all, "time_logging", "u32"};
+		Column<uint32_t> timeRadio{all, "time_radio", "u32"};
+		Column<uint32_t> timeTotal{all, "time_total", "u32"};
+
+		Column<float> ballX{all, "ball_x", "f32"};
+		Column<float> ballY{all, "ball_y", "f32"};
+		Column<float> ballVx{all, "ball_vx", "f32"};
+		Column<float> ballVy{all, "ball_vy", "f32"};
+
+		Column<float> selfX{all, "self_x", "f32", Num_Shells};
+		Column<float> selfY{all, "self_y", "f32", Num_Shells};
+		Column<float> selfAngle{all, "self_angle", "f32", Num_Shells};
+		Column<float> selfVx{all, "self_vx", "f32", Num_Shells};
+		Column<float> selfVy{all, "self_vy", "f32", Num_Shells};
+		Column<float> selfCmdVx{all, "self_cmd_vx", "f32", Num_Shells};
+		Column<float> selfCmdVy{all, "self_cmd_vy", "f32", Num_Shells};
+		Column<float> selfCmdW{all, "self_cmd_w", "f32", Num_Shells};
+
+		Column<float> oppX{all, "opp_x", "f32", Num_Shells};
+		Column<float> oppY{all, "opp_y", "f32", Num_Shells};
+		Column<float> oppAngle{all, "opp_angle", "f32", Num_Shells};
+		Column<float> oppVx{all, "opp_vx", "f32", Num_Shells};
+		Column<float> oppVy{all, "opp_vy", "f32", Num_Shells};
+
+		Column<float> txBodyX{all, "radio_tx_body_x", "f32", Num_Shells};
+		Column<float> txBodyY{all, "radio_tx_body_y", "f32", Num_Shells};
+		Column<float> txBodyW{all, "radio_tx_body_w", "f32", Num_Shells};
+		Column<uint8_t> txKick{all, "radio_tx_kick", "u8", Num_Shells};
+		Column<uint8_t> txChip{all, "radio_tx_chip", "u8", Num_Shells};
+		Column<uint8_t> txDribbler{all, "radio_tx_dribbler", "u8", Num_Shells};
+
+		/// Fills row @row from @frame.  Different rows may be filled by different threads.
+		void extract(const LogFrame &frame, int row)
+		{
+			commandTime(row) = frame.command_time();
+			blueTeam(row) = frame.blue_team();
+			rawVisionPackets(row) = min(frame.raw_vision_size(), 255);
+			visionToRadioLatency(row) = frame.vision_to_radio_latency();
+
+			const LogFrame::Timing &timing = frame.timing();
+			timeVision(row) = timing.vision();
+			timeModels(row) = timing.models();
+			timeReferee(row) = timing.referee();
+			timeGameplayPython(row) = timing.gameplay_python();
+			timeGameplayPlanning(row) = timing.gameplay_planning();
+			timeMotionControl(row) = timing.motion_control();
+			timeLogging(row) = timing.logging();
+			timeRadio(row) = timing.radio();
+			timeTotal(row) = timing.total();
+
+			if (frame.has_ball())
+			{
+				ballX(row) = frame.ball().pos().x();
+				ballY(row) = frame.ball().pos().y();
+				ballVx(row) = frame.ball().vel().x();
+				ballVy(row) = frame.ball().vel().y();
+			}
+
+			for (int i = 0; i < frame.self_size(); ++i)
+			{
+				const LogFrame::Robot &r = frame.self(i);
+				unsigned int s = r.shell();
+				if (s >= Num_Shells)
+				{
+					continue;
+				}
+
+				selfX(row, s) = r.pos().x();
+				selfY(row, s) = r.pos().y();
+				selfAngle(row, s) = r.angle();
+				selfVx(row, s) = r.vel().x();
+				selfVy(row, s) = r.vel().y();
+				if (r.has_cmd_vel())
+				{
+					selfCmdVx(row, s) = r.cmd_vel().x();
+					selfCmdVy(row, s) = r.cmd_vel().y();
+				}
+				if (r.has_cmd_w())
+				{
+					selfCmdW(row, s) = r.cmd_w();
+				}
+			}
+
+			for (int i = 0; i < frame.opp_size(); ++i)
+			{
+				const LogFrame::Robot &r = frame.opp(i);
+				unsigned int s = r.shell();
+				if (s >= Num_Shells)
+				{
+					continue;
+				}
+
+				oppX(row, s) = r.pos().x();
+				oppY(row, s) = r.pos().y();
+				oppAngle(row, s) = r.angle();
+				oppVx(row, s) = r.vel().x();
+				oppVy(row, s) = r.vel().y();
+			}
+
+			for (int i = 0; i < frame.radio_tx().robots_size(); ++i)
+			{
+				const RadioTx::Robot &r = frame.radio_tx().robots(i);
+				unsigned int s = r.robot_id();
+				if (s >= Num_Shells)
+				{
+					continue;
+				}
+
+				txBodyX(row, s) = r.body_x();
+				txBodyY(row, s) = r.body_y();
+				txBodyW(row, s) = r.body_w();
+				txKick(row, s) = min(r.kick(), 255u);
+				txChip(row, s) = r.use_chipper();
+				txDribbler(row, s) = max(0, min(r.dribbler(), 255));
+			}
+		}
+};
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3)
+	{
+		printf("Usage: %s <input.log> <output dir>\n", argv[0]);
+		return 1;
+	}
+
+	LogReader log;
+	if (!log.open(argv[1]))
+	{
+		return 1;
+	}
+
+	QString dir = argv[2];
+	if (!QDir().mkpath(dir))
+	{
+		printf("Can't create %s\n", argv[2]);
+		return 1;
+	}
+
+	Columns columns;
+	for (unsigned int c = 0; c < columns.all.size(); ++c)
+	{
+		if (!columns.all[c]->open(dir))
+		{
+			return 1;
+		}
+	}
+
+	int numThreads = max(1u, thread::hardware_concurrency());
+	vector<string> records(BatchSize);
+	int numFrames = log.numFrames();
+	int written = 0;
+	for (int start = 0; start < numFrames; start += BatchSize)
+	{
+		int n = min(BatchSize, numFrames - start);
+
+		// Reading is sequential because LogReader decompresses one chunk at a time
+		for (int i = 0; i < n; ++i)
+		{
+			if (!log.rawFrame(start + i, records[i]))
+			{
+				records[i].clear();
+			}
+		}
+
+		for (unsigned int c = 0; c < columns.all.size(); ++c)
+		{
+			columns.all[c]->reset(n);
+		}
+
+		// Each thread decodes a contiguous range of the batch
+		vector<thread> threads;
+		for (int t = 0; t < numThreads; ++t)
+		{
+			threads.push_back(thread([&, t]()
+			{
+				LogFrame frame;
+				int end = (int64_t)n * (t + 1) / numThreads;
+				for (int i = (int64_t)n * t / numThreads; i < end; ++i)
+				{
+					frame.Clear();
+					// Parse partial so we can recover from corrupt data
+					if (!records[i].empty() && frame.ParsePartialFromString(records[i]))
+					{
+						columns.extract(frame, i);
+					}
+				}
+			}));
+		}
+		for (unsigned int t = 0; t < threads.size(); ++t)
+		{
+			threads[t].join();
+		}
+
+		for (unsigned int c = 0; c < columns.all.size(); ++c)
+		{
+			if (!columns.all[c]->write(n))
+			{
+				printf("Failed to write %s: %m\n", columns.all[c]->name);
+				return 1;
+			}
+		}
+		written += n;
+	}
+
+	QString manifest = dir + "/columns.txt";
+	FILE *fp = fopen(manifest.toAscii(), "w");
+	if (!fp)
+	{
+		printf("Can't create %s: %m\n", (const char *)manifest.toAscii());
+		return 1;
+	}
+	fprintf(fp, "frames %d\n", written);
+	for (unsigned int c = 0; c < columns.all.size(); ++c)
+	{
+		fprintf(fp, "%s %s %d\n", columns.all[c]->name, columns.all[c]->type, columns.all[c]->width);
+	}
+	fclose(fp);
+
+	printf("Exported %d frames to %s\n", written, argv[2]);
+	return 0;
+}
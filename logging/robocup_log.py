@@ -1,17 +1,54 @@
 import struct
+import zlib
 from LogFrame_pb2 import *
 
+# See common/ChunkedLog.hpp for the chunked format
+ChunkedMagic = 'RJLOGCHK'
+FileHeader = struct.Struct('<8sII')
+ChunkHeader = struct.Struct('<IIIIQQII')
+ChunkMagic = 0x4b4e4843
+
 class RobocupLog:
 	def __init__(self, filename):
 		self.f = file(filename)
+		self.chunked = self.f.read(FileHeader.size)[:8] == ChunkedMagic
+		if not self.chunked:
+			self.f.seek(0)
+		self.chunk = ''
+		self.pos = 0
+
+	# Returns the next record from the current chunk, reading a new chunk if needed.
+	# Stops at the index or at a torn chunk.
+	def readChunkedRecord(self):
+		if self.pos >= len(self.chunk):
+			data = self.f.read(ChunkHeader.size)
+			if len(data) < ChunkHeader.size:
+				return None
+			magic, compressedSize, rawSize, numFrames, firstTime, lastTime, crc, reserved = ChunkHeader.unpack(data)
+			if magic != ChunkMagic:
+				return None
+			data = self.f.read(compressedSize)
+			if len(data) < compressedSize or (zlib.crc32(data) & 0xffffffff) != crc:
+				return None
+			self.chunk = zlib.decompress(data)
+			self.pos = 0
+
+		num_bytes = struct.unpack_from('<I', self.chunk, self.pos)[0]
+		data = self.chunk[self.pos + 4:self.pos + 4 + num_bytes]
+		self.pos += 4 + num_bytes
+		return data
 
 	def readFrame(self):
-		data = self.f.read(4)
-		if len(data) == 0:
-			return None
-		num_bytes = struct.unpack('<I', data)[0]
-		data = self.f.read(num_bytes)
+		if self.chunked:
+			data = self.readChunkedRecord()
+			if data is None:
+				return None
+		else:
+			data = self.f.read(4)
+			if len(data) == 0:
+				return None
+			num_bytes = struct.unpack('<I', data)[0]
+			data = self.f.read(num_bytes)
 		frame = LogFrame()
 		frame.ParseFromString(data)
 		return frame
-
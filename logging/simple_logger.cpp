@@ -9,6 +9,7 @@
 #include <multicast.hpp>
 #include <Network.hpp>
 #include <Utils.hpp>
+#include <ChunkedLog.hpp>
 
 #include <unistd.h>
 #include <fcntl.h>
@@ -67,6 +68,13 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 	
+	ChunkedLog::Writer log;
+	if (!log.open(fd))
+	{
+		printf("Can't write to %s: %m\n", (const char *)logFile.toAscii());
+		return 1;
+	}
+	
 	printf("Writing to %s\n", (const char *)logFile.toAscii());
 	
 	// Main loop
@@ -132,12 +140,8 @@ int main(int argc, char *argv[])
 			logConfig->set_git_version_dirty(git_version_dirty);
 		}
 		
-		uint32_t size = logFrame.ByteSize();
-		if (write(fd, &size, sizeof(size)) != sizeof(size))
-		{
-			printf("Failed to write size: %m\n");
-			break;
-		} else if (!logFrame.SerializeToFileDescriptor(fd))
+		logFrame.ByteSize();
+		if (!log.addFrame(logFrame))
 		{
 			printf("Failed to write frame: %m\n");
 			break;
@@ -153,6 +157,12 @@ int main(int argc, char *argv[])
 		}
 	}
 	
+	if (!log.close())
+	{
+		printf("Failed to finish log: %m\n");
+	}
+	close(fd);
+	
 	// Discard input on stdin
 	tcflush(0, TCIFLUSH);
 	
@@ -15,6 +15,7 @@
 #include <protobuf/messages_robocup_ssl_wrapper.pb.h>
 
 #include <iostream>
+#include <poll.h>
 #include <sys/time.h>
 #include <Constants.hpp>
 #include <Network.hpp>
@@ -35,6 +36,8 @@ Environment::Environment(const QString& configFile, bool sendShared_, SimEngine*
  	_configFile(configFile),
  	_frameNumber(0),
  	_stepCount(0),
+ 	_fixedStep(false),
+ 	_simTime(0),
  	_simEngine(engine),
  	sendShared(sendShared_),
  	ballVisibility(100)
@@ -49,7 +52,7 @@ Environment::~Environment() {
 	delete _field;
 }
 
-void Environment::connectSockets() {
+void Environment::connectSockets(bool startTimer) {
 	// Bind sockets
 	bool success = (
 		_visionSocket.bind(SimCommandPort)
@@ -62,6 +65,14 @@ void Environment::connectSockets() {
 
 	gettimeofday(&_lastStepTime, 0);
 
+	if (!startTimer)
+	{
+		// Simulated time starts at the wall clock so timestamps look normal to soccer
+		_fixedStep = true;
+		_simTime = _lastStepTime.tv_sec + (double)_lastStepTime.tv_usec * 1.0e-6;
+		return;
+	}
+
 	connect(&_timer, SIGNAL(timeout()), SLOT(step()));
 	_timer.start(16 / Oversample);
 }
@@ -78,6 +89,23 @@ void Environment::preStep(float deltaTime){
 	}
 }
 
+void Environment::stepFixed(float dt)
+{
+	preStep(dt);
+	_simEngine->stepSimulation(dt);
+	_simTime += dt;
+	step();
+}
+
+bool Environment::waitForRadio(int timeout_ms)
+{
+	struct pollfd fds[2];
+	fds[0].fd = _radioSocketBlue.socketDescriptor();
+	fds[1].fd = _radioSocketYellow.socketDescriptor();
+	fds[0].events = fds[1].events = POLLIN;
+	return poll(fds, 2, timeout_ms) > 0;
+}
+
 void Environment::step()
 {
 
@@ -216,9 +244,14 @@ void Environment::sendVision()
 	det->set_frame_number(_frameNumber++);
 	det->set_camera_id(0);
 
-	struct timeval tv;
-	gettimeofday(&tv, 0);
-	det->set_t_capture(tv.tv_sec + (double)tv.tv_usec * 1.0e-6);
+	if (_fixedStep)
+	{
+		det->set_t_capture(_simTime);
+	} else {
+		struct timeval tv;
+		gettimeofday(&tv, 0);
+		det->set_t_capture(tv.tv_sec + (double)tv.tv_usec * 1.0e-6);
+	}
 	det->set_t_sent(det->t_capture());
 
 	BOOST_FOREACH(Robot *robot, _yellow)
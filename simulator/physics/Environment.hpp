@@ -50,6 +50,13 @@ private:
 
 	struct timeval _lastStepTime;
 
+	// If true, time is advanced only by stepFixed() and vision timestamps
+	// come from _simTime instead of the wall clock.
+	bool _fixedStep;
+
+	// Simulated time in seconds, used when _fixedStep is set
+	double _simTime;
+
 	// How many vision frames we've sent
 	int _frameNumber;
 
@@ -71,8 +78,11 @@ public:
 
 	~Environment();
 
-	/** initializes the timer, connects sockets */
-	void connectSockets();
+	/**
+	 * connects sockets and, if @startTimer is set, starts the step timer.
+	 * Without the timer the caller must drive the environment with stepFixed().
+	 */
+	void connectSockets(bool startTimer = true);
 
 	void dropFrame()
 	{
@@ -107,6 +117,21 @@ public:
 	//sets engine forces on robots before physics tick
 	void preStep(float deltaTime);
 
+	/**
+	 * Advances physics and the environment by exactly @dt seconds of simulated time.
+	 * Used in headless mode in place of the GLUT idle loop and the step timer.
+	 */
+	void stepFixed(float dt);
+
+	/**
+	 * Blocks until a radio packet from either team is pending or @timeout_ms passes.
+	 * Returns true if a packet is pending.
+	 */
+	bool waitForRadio(int timeout_ms);
+
+	/** simulated time in seconds, used for vision timestamps in fixed-step mode */
+	double simTime() const { return _simTime; }
+
 	/**
 	 * Primary environment step function - called by a timer at a fixed interval
 	 */
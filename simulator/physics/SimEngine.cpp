@@ -166,6 +166,12 @@ void SimEngine::stepSimulation() {
 	}
 }
 
+void SimEngine::stepSimulation(float dt) {
+	if (_dynamicsWorld) {
+		_dynamicsWorld->stepSimulation(dt, 1, dt);
+	}
+}
+
 void SimEngine::debugDrawWorld() {
 	if (_dynamicsWorld)
 		_dynamicsWorld->debugDrawWorld();
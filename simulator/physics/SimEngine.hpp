@@ -67,6 +67,12 @@ public:
 	/** Key function for advancing the simulation forward in time */
 	void stepSimulation();
 
+	/**
+	 * Advances the simulation by exactly @dt seconds in a single substep,
+	 * independent of the wall clock.  Repeated calls with the same @dt are deterministic.
+	 */
+	void stepSimulation(float dt);
+
 	btClock* getClock();
 
 	void debugDrawWorld();
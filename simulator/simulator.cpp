@@ -7,7 +7,9 @@
 #include <QThread>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <signal.h>
+#include <sys/time.h>
 
 using namespace std;
 
@@ -17,19 +19,79 @@ void quit(int signal)
 	exit(0);
 }
 
+// Simulated time per step in headless mode, matching the step timer interval
+static const float HeadlessStep = 0.016f;
+
+// How long a lockstep simulator waits for soccer before stepping anyway
+static const int LockstepTimeout_ms = 1000;
+
 void usage(const char* prog)
 {
-	fprintf(stderr, "usage: %s [-c <config file>] [--glut] [--sv]\n", prog);
-	fprintf(stderr, "\t--help  Show usage message\n");
-	fprintf(stderr, "\t--sv    Use shared vision multicast port\n");
+	fprintf(stderr, "usage: %s [-c <config file>] [--glut] [--sv] [--headless [--duration <s>] [--seed <n>] [--lockstep]]\n", prog);
+	fprintf(stderr, "\t--help      Show usage message\n");
+	fprintf(stderr, "\t--sv        Use shared vision multicast port\n");
+	fprintf(stderr, "\t--headless  Run without graphics, stepping physics at a fixed timestep as fast as possible\n");
+	fprintf(stderr, "\t--duration  Stop after this many simulated seconds (headless only, default runs forever)\n");
+	fprintf(stderr, "\t--seed      Random seed for vision dropouts (headless only)\n");
+	fprintf(stderr, "\t--lockstep  Wait for radio commands after each vision frame (headless only, for soccer -lockstep)\n");
+}
+
+static double wallTime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+/**
+ * Runs the simulation in lockstep with a fixed timestep and no GLUT or OpenGL.
+ * Each step applies robot commands, advances physics by HeadlessStep and sends vision.
+ */
+static int runHeadless(const QString& configFile, bool sendShared, double duration, bool lockstep)
+{
+	SimEngine simEngine;
+	simEngine.initPhysics();
+
+	Environment env(configFile, sendShared, &simEngine);
+	env.connectSockets(false);
+
+	const double start = env.simTime();
+	const double wallStart = wallTime();
+	while (duration <= 0 || env.simTime() - start < duration)
+	{
+		env.stepFixed(HeadlessStep);
+		if (lockstep)
+		{
+			// Let soccer process the vision frame just sent before stepping again
+			env.waitForRadio(LockstepTimeout_ms);
+		}
+		QCoreApplication::processEvents();
+	}
+
+	double elapsed = wallTime() - wallStart;
+	printf("Simulated %.1f s in %.1f s (%.1fx real time)\n",
+		duration, elapsed, elapsed > 0 ? duration / elapsed : 0.0);
+	return 0;
 }
 
 int main(int argc, char* argv[])
 {
-	QApplication app(argc, argv);
+	bool headless = false;
+	for (int i=1 ; i<argc ; ++i)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			headless = true;
+		}
+	}
+
+	// Without a GUI there is no connection to the display
+	QApplication app(argc, argv, !headless);
 
 	QString configFile = "simulator.cfg";
 	bool sendShared = false;
+	double duration = 0;
+	bool lockstep = false;
 
 	//loop arguments and look for config file
 	for (int i=1 ; i<argc ; ++i)
@@ -41,6 +103,36 @@ int main(int argc, char* argv[])
 		} else if (strcmp(argv[i], "--sv") == 0)
 		{
 			sendShared = true;
+		} else if (strcmp(argv[i], "--headless") == 0)
+		{
+			// Handled above
+		} else if (strcmp(argv[i], "--lockstep") == 0)
+		{
+			lockstep = true;
+		} else if (strcmp(argv[i], "--duration") == 0)
+		{
+			++i;
+			if (i < argc)
+			{
+				duration = atof(argv[i]);
+			}
+			else
+			{
+				printf ("Expected number of seconds after --duration parameter\n");
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--seed") == 0)
+		{
+			++i;
+			if (i < argc)
+			{
+				srand(atoi(argv[i]));
+			}
+			else
+			{
+				printf ("Expected seed after --seed parameter\n");
+				return 1;
+			}
 		} else if (strcmp(argv[i], "-c") == 0)
 		{
 			++i;
@@ -63,14 +155,19 @@ int main(int argc, char* argv[])
 		}
 	}
 
-	// create the thread for simulation
-	SimulatorGLUTThread sim_thread(argc, argv, configFile, sendShared);
-
 	struct sigaction act;
 	memset(&act, 0, sizeof(act));
 	act.sa_handler = quit;
 	sigaction(SIGINT, &act, 0);
 
+	if (headless)
+	{
+		return runHeadless(configFile, sendShared, duration, lockstep);
+	}
+
+	// create the thread for simulation
+	SimulatorGLUTThread sim_thread(argc, argv, configFile, sendShared);
+
 	// Create and initialize GUI with environment information
 	SimulatorWindow win(sim_thread.env());
 	win.show();
@@ -0,0 +1,350 @@
+#include "LogReader.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace std;
+using namespace Packet;
+
+// Identifies an index file and its format
+static const char IndexMagic[8] = {'R', 'J', 'L', 'O', 'G', 'I', 'D', 'X'};
+static const uint32_t IndexVersion = 1;
+
+LogReader::LogReader(int cacheSize)
+{
+	_fd = -1;
+	_data = 0;
+	_size = 0;
+	_mtime = 0;
+	_numFrames = 0;
+	_indexFromCache = false;
+	_chunked = false;
+	_recovered = false;
+	_decodedChunk = -1;
+	_cacheSize = cacheSize;
+}
+
+LogReader::~LogReader()
+{
+	close();
+}
+
+bool LogReader::open(const QString &filename)
+{
+	close();
+
+	_fd = ::open(filename.toAscii(), O_RDONLY);
+	if (_fd < 0)
+	{
+		fprintf(stderr, "Can't open %s: %m\n", (const char *)filename.toAscii());
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(_fd, &st) < 0)
+	{
+		fprintf(stderr, "Can't stat %s: %m\n", (const char *)filename.toAscii());
+		close();
+		return false;
+	}
+	_size = st.st_size;
+	_mtime = st.st_mtime;
+
+	if (_size)
+	{
+		void *data = mmap(0, _size, PROT_READ, MAP_SHARED, _fd, 0);
+		if (data == MAP_FAILED)
+		{
+			fprintf(stderr, "Can't map %s: %m\n", (const char *)filename.toAscii());
+			close();
+			return false;
+		}
+		_data = (const uint8_t *)data;
+	}
+
+	_chunked = ChunkedLog::readIndex(_data, _size, _chunks, &_recovered);
+	if (_chunked)
+	{
+		if (_recovered)
+		{
+			fprintf(stderr, "LogReader: %s was not closed cleanly, recovered %d chunks\n",
+				(const char *)filename.toAscii(), (int)_chunks.size());
+		}
+
+		_chunkFirstFrame.reserve(_chunks.size());
+		for (unsigned int c = 0; c < _chunks.size(); ++c)
+		{
+			_chunkFirstFrame.push_back(_numFrames);
+			_numFrames += _chunks[c].numFrames;
+		}
+		return true;
+	}
+
+	_indexFromCache = loadIndex(indexFilename(filename));
+	if (!_indexFromCache)
+	{
+		buildIndex();
+		saveIndex(indexFilename(filename));
+	}
+	_numFrames = _offsets.size();
+
+	return true;
+}
+
+void LogReader::close()
+{
+	_cache.clear();
+	_lru.clear();
+	_offsets.clear();
+	_numFrames = 0;
+	_indexFromCache = false;
+	_chunked = false;
+	_recovered = false;
+	_chunks.clear();
+	_chunkFirstFrame.clear();
+	_decodedChunk = -1;
+	_decoded.clear();
+	_decodedOffsets.clear();
+
+	if (_data)
+	{
+		munmap((void *)_data, _size);
+		_data = 0;
+	}
+	_size = 0;
+
+	if (_fd >= 0)
+	{
+		::close(_fd);
+		_fd = -1;
+	}
+}
+
+void LogReader::buildIndex()
+{
+	_offsets.clear();
+
+	uint64_t pos = 0;
+	while (pos + sizeof(uint32_t) <= _size)
+	{
+		uint32_t size;
+		memcpy(&size, _data + pos, sizeof(size));
+		if (pos + sizeof(size) + size > _size)
+		{
+			fprintf(stderr, "LogReader: ignoring torn record at offset %lu\n", (unsigned long)pos);
+			break;
+		}
+
+		_offsets.push_back(pos);
+		pos += sizeof(size) + size;
+	}
+}
+
+bool LogReader::validRecord(uint64_t offset) const
+{
+	if (offset > _size || _size - offset < sizeof(uint32_t))
+	{
+		return false;
+	}
+
+	uint32_t size;
+	memcpy(&size, _data + offset, sizeof(size));
+	return _size - offset - sizeof(size) >= size;
+}
+
+bool LogReader::loadIndex(const QString &filename)
+{
+	FILE *fp = fopen(filename.toAscii(), "rb");
+	if (!fp)
+	{
+		return false;
+	}
+
+	char magic[sizeof(IndexMagic)];
+	uint32_t version = 0;
+	uint64_t size = 0;
+	int64_t mtime = 0;
+	uint64_t count = 0;
+	bool ok = fread(magic, sizeof(magic), 1, fp) == 1 &&
+		memcmp(magic, IndexMagic, sizeof(magic)) == 0 &&
+		fread(&version, sizeof(version), 1, fp) == 1 && version == IndexVersion &&
+		fread(&size, sizeof(size), 1, fp) == 1 && size == _size &&
+		fread(&mtime, sizeof(mtime), 1, fp) == 1 && mtime == _mtime &&
+		fread(&count, sizeof(count), 1, fp) == 1;
+
+	// Every record takes at least a size word, so a larger count can't be right
+	ok = ok && count <= _size / sizeof(uint32_t);
+
+	if (ok)
+	{
+		_offsets.resize(count);
+		ok = count == 0 || fread(&_offsets[0], sizeof(_offsets[0]), count, fp) == count;
+
+		// A stale or corrupt index must not send frame() past the end of the log
+		for (uint64_t i = 0; ok && i < count; ++i)
+		{
+			ok = validRecord(_offsets[i]);
+		}
+
+		if (!ok)
+		{
+			fprintf(stderr, "LogReader: ignoring bad index %s\n", (const char *)filename.toAscii());
+			_offsets.clear();
+		}
+	}
+
+	fclose(fp);
+	return ok;
+}
+
+void LogReader::saveIndex(const QString &filename)
+{
+	// Failing to save the index only makes the next open slower
+	FILE *fp = fopen(filename.toAscii(), "wb");
+	if (!fp)
+	{
+		return;
+	}
+
+	uint64_t count = _offsets.size();
+	fwrite(IndexMagic, sizeof(IndexMagic), 1, fp);
+	fwrite(&IndexVersion, sizeof(IndexVersion), 1, fp);
+	fwrite(&_size, sizeof(_size), 1, fp);
+	fwrite(&_mtime, sizeof(_mtime), 1, fp);
+	fwrite(&count, sizeof(count), 1, fp);
+	if (count)
+	{
+		fwrite(&_offsets[0], sizeof(_offsets[0]), count, fp);
+	}
+
+	if (fclose(fp) != 0)
+	{
+		unlink(filename.toAscii());
+	}
+}
+
+const uint8_t *LogReader::chunkedRecord(int i)
+{
+	// Find the last chunk that starts at or before frame i
+	int c = upper_bound(_chunkFirstFrame.begin(), _chunkFirstFrame.end(), i) - _chunkFirstFrame.begin() - 1;
+
+	if (c != _decodedChunk)
+	{
+		_decodedChunk = -1;
+		_decodedOffsets.clear();
+		if (!ChunkedLog::readChunk(_data, _size, _chunks[c], _decoded))
+		{
+			fprintf(stderr, "LogReader: chunk %d is corrupt\n", c);
+			return 0;
+		}
+
+		// The CRC matched, but don't trust sizes to stay inside the chunk
+		for (uint64_t pos = 0; pos + sizeof(uint32_t) <= _decoded.size();)
+		{
+			uint32_t size;
+			memcpy(&size, &_decoded[pos], sizeof(size));
+			if (_decoded.size() - pos - sizeof(size) < size)
+			{
+				fprintf(stderr, "LogReader: ignoring torn record in chunk %d\n", c);
+				break;
+			}
+			_decodedOffsets.push_back(pos);
+			pos += sizeof(size) + size;
+		}
+		_decodedChunk = c;
+	}
+
+	unsigned int r = i - _chunkFirstFrame[c];
+	if (r >= _decodedOffsets.size())
+	{
+		return 0;
+	}
+	return (const uint8_t *)&_decoded[_decodedOffsets[r]];
+}
+
+const uint8_t *LogReader::record(int i)
+{
+	if (i < 0 || i >= _numFrames)
+	{
+		return 0;
+	}
+
+	if (_chunked)
+	{
+		return chunkedRecord(i);
+	}
+
+	// Offsets from an index were checked when it was loaded, but check again since
+	// reading past the end of the mapping would crash
+	if (!validRecord(_offsets[i]))
+	{
+		fprintf(stderr, "LogReader: frame %d is outside the log\n", i);
+		return 0;
+	}
+	return _data + _offsets[i];
+}
+
+bool LogReader::rawFrame(int i, string &data)
+{
+	const uint8_t *rec = record(i);
+	if (!rec)
+	{
+		return false;
+	}
+
+	uint32_t size;
+	memcpy(&size, rec, sizeof(size));
+	data.assign((const char *)rec + sizeof(size), size);
+	return true;
+}
+
+shared_ptr<LogFrame> LogReader::frame(int i)
+{
+	if (i < 0 || i >= _numFrames)
+	{
+		return shared_ptr<LogFrame>();
+	}
+
+	unordered_map<int, CacheEntry>::iterator cached = _cache.find(i);
+	if (cached != _cache.end())
+	{
+		// Move to the front of the LRU list
+		_lru.splice(_lru.begin(), _lru, cached->second.lru);
+		return cached->second.frame;
+	}
+
+	const uint8_t *rec = record(i);
+	if (!rec)
+	{
+		return shared_ptr<LogFrame>();
+	}
+
+	uint32_t size;
+	memcpy(&size, rec, sizeof(size));
+
+	shared_ptr<LogFrame> frame = make_shared<LogFrame>();
+	// Parse partial so we can recover from corrupt data
+	if (!frame->ParsePartialFromArray(rec + sizeof(size), size))
+	{
+		fprintf(stderr, "LogReader: can't parse frame %d\n", i);
+		return shared_ptr<LogFrame>();
+	}
+
+	if ((int)_cache.size() >= _cacheSize)
+	{
+		_cache.erase(_lru.back());
+		_lru.pop_back();
+	}
+
+	_lru.push_front(i);
+	CacheEntry &entry = _cache[i];
+	entry.frame = frame;
+	entry.lru = _lru.begin();
+
+	return frame;
+}
@@ -0,0 +1,129 @@
+// Random access to LogFrames in a log file written by Logger.
+//
+// Both the chunked format (see ChunkedLog) and the older format of plain
+// length-prefixed records are supported.
+//
+// The file is memory-mapped and only an index is built when it is opened.
+// Frames are parsed when they are first requested and a limited number of parsed frames
+// are kept in a least-recently-used cache, so memory use does not grow with the length of the log.
+//
+// Chunked logs carry their own index.  For plain logs, the index of record offsets is saved
+// next to the log as <filename>.idx so reopening a large log is instant.
+// The index file records the size and modification time of the log and is rebuilt if they change.
+//
+// A torn record or chunk at the end of the file (e.g. from a crash while logging) is ignored.
+//
+// This class is not thread-safe.
+
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+#include <ChunkedLog.hpp>
+
+#include <QString>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <stdint.h>
+
+class LogReader
+{
+	public:
+		LogReader(int cacheSize = 1024);
+		~LogReader();
+
+		/// Opens a log file, replacing any previously opened file.
+		/// Returns false if the file can't be read.
+		bool open(const QString &filename);
+
+		void close();
+
+		/// Number of complete frames in the file
+		int numFrames() const
+		{
+			return _numFrames;
+		}
+
+		/// Returns frame @i, parsing it if it is not in the cache.
+		/// Returns null if @i is out of range or the frame can't be parsed.
+		std::shared_ptr<Packet::LogFrame> frame(int i);
+
+		/// Copies the serialized LogFrame @i into @data without parsing it or caching it.
+		/// Returns false if @i is out of range or its chunk is corrupt.
+		bool rawFrame(int i, std::string &data);
+
+		/// True if the index was loaded from the sidecar file instead of scanning the log
+		bool indexFromCache() const
+		{
+			return _indexFromCache;
+		}
+
+		/// True if the file is a chunked log
+		bool chunked() const
+		{
+			return _chunked;
+		}
+
+		/// True if a chunked log had no index and its chunks were found by scanning
+		bool recovered() const
+		{
+			return _recovered;
+		}
+
+		static QString indexFilename(const QString &filename)
+		{
+			return filename + ".idx";
+		}
+
+	private:
+		/// Scans the mapped file and fills _offsets
+		void buildIndex();
+
+		/// Finds the start of frame @i in a chunked log, decompressing its chunk if needed
+		const uint8_t *chunkedRecord(int i);
+
+		/// Finds the start of the record (size and data) for frame @i.
+		/// Returns null if @i is out of range or the record can't be read.
+		const uint8_t *record(int i);
+
+		/// True if a whole record (size and data) starts at @offset in a legacy log
+		bool validRecord(uint64_t offset) const;
+
+		bool loadIndex(const QString &filename);
+		void saveIndex(const QString &filename);
+
+		int _fd;
+		const uint8_t *_data;
+		uint64_t _size;
+		int64_t _mtime;
+
+		int _numFrames;
+
+		/// Offset of each record's size field in the file (plain logs only)
+		std::vector<uint64_t> _offsets;
+
+		bool _indexFromCache;
+
+		bool _chunked;
+		bool _recovered;
+
+		/// Chunks in a chunked log and the number of the first frame in each
+		std::vector<ChunkedLog::IndexEntry> _chunks;
+		std::vector<int> _chunkFirstFrame;
+
+		/// The most recently decompressed chunk and the offsets of its records
+		int _decodedChunk;
+		std::string _decoded;
+		std::vector<uint32_t> _decodedOffsets;
+
+		/// Parsed frames.  The most recently used frame is at the front of _lru.
+		int _cacheSize;
+		std::list<int> _lru;
+		struct CacheEntry
+		{
+			std::shared_ptr<Packet::LogFrame> frame;
+			std::list<int>::iterator lru;
+		};
+		std::unordered_map<int, CacheEntry> _cache;
+};
@@ -1,18 +1,13 @@
 #include <LogViewer.hpp>
 
-#include <google/protobuf/io/zero_copy_stream_impl.h>
-
 #include <QApplication>
-#include <QFile>
 
 #include <algorithm>
-#include <fcntl.h>
 #include <stdio.h>
 
 using namespace std;
 using namespace boost;
 using namespace Packet;
-using namespace google::protobuf::io;
 
 void usage(const char *prog)
 {
@@ -67,47 +62,14 @@ LogViewer::LogViewer(QWidget* parent): QMainWindow(parent)
 
 bool LogViewer::readFrames(const char *filename)
 {
-	frames.clear();
 	ui.timeSlider->setMaximum(0);
 	
-	QFile file(filename);
-	if (!file.open(QFile::ReadOnly))
+	if (!log.open(filename))
 	{
-		fprintf(stderr, "Can't open %s: %s\n", filename, (const char *)file.errorString().toAscii());
 		return false;
 	}
 	
-	int n = 0;
-	while (!file.atEnd())
-	{
-		uint32_t size = 0;
-		if (file.read((char *)&size, sizeof(size)) != sizeof(size))
-		{
-			// Broken length
-			printf("Broken length\n");
-			return false;
-		}
-		
-		string str(size, 0);
-		if (file.read(&str[0], size) != size)
-		{
-			// Broken packet at end of file
-			printf("Broken packet\n");
-			return false;
-		}
-		
-		std::shared_ptr<LogFrame> frame = std::make_shared<LogFrame>();
-		frames.push_back(frame);
-		// Parse partial so we can recover from corrupt data
-		if (!frame->ParsePartialFromString(str))
-		{
-			printf("Failed: %s\n", frame->InitializationErrorString().c_str());
-			return false;
-		}
-		++n;
-	}
-	
-	ui.timeSlider->setMaximum(frames.size());
+	ui.timeSlider->setMaximum(log.numFrames());
 	return true;
 }
 
@@ -121,12 +83,23 @@ void LogViewer::updateViews()
 	}
 	_lastUpdateTime = time;
 	
+	if (!log.numFrames())
+	{
+		return;
+	}
+	
 	// Limit to available data
 	_doubleFrameNumber = max(0.0, _doubleFrameNumber);
-	_doubleFrameNumber = min(frames.size() - 1.0, _doubleFrameNumber);
+	_doubleFrameNumber = min(log.numFrames() - 1.0, _doubleFrameNumber);
 	
 	int f = frameNumber();
-	const LogFrame &currentFrame = *frames[f];
+	std::shared_ptr<LogFrame> current = log.frame(f);
+	std::shared_ptr<LogFrame> first = log.frame(0);
+	if (!current || !first)
+	{
+		return;
+	}
+	const LogFrame &currentFrame = *current;
 	
 	ui.timeSlider->setValue(f);
 	
@@ -134,7 +107,7 @@ void LogViewer::updateViews()
 	int n = min(f, (int)_history.size());
 	for (int i = 0; i < n; ++i)
 	{
-		_history[i] = frames[f - i];
+		_history[i] = log.frame(f - i);
 	}
 	for (int i = n; i < (int)_history.size(); ++i)
 	{
@@ -143,7 +116,7 @@ void LogViewer::updateViews()
 	
 	// Update non-message tree items
 	_frameNumberItem->setData(ProtobufTree::Column_Value, Qt::DisplayRole, frameNumber());
-	int elapsedMillis = (currentFrame.command_time() - frames[0]->command_time() + 500) / 1000;
+	int elapsedMillis = (currentFrame.command_time() - first->command_time() + 500) / 1000;
 	QTime elapsedTime = QTime().addMSecs(elapsedMillis);
 	_elapsedTimeItem->setText(ProtobufTree::Column_Value, elapsedTime.toString("hh:mm:ss.zzz"));
 	
@@ -230,5 +203,5 @@ void LogViewer::on_logBeginning_clicked()
 
 void LogViewer::on_logEnd_clicked()
 {
-	frameNumber(frames.size() - 1);
+	frameNumber(log.numFrames() - 1);
 }
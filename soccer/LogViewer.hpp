@@ -2,6 +2,7 @@
 
 #include <ui_LogViewer.h>
 #include <protobuf/LogFrame.pb.h>
+#include <LogReader.hpp>
 
 #include <QTime>
 #include <QTimer>
@@ -24,10 +25,10 @@ class LogViewer: public QMainWindow
 			_doubleFrameNumber = value;
 		}
 		
-		// This is called when 
+		// Opens a log file.  Frames are read from it as they are displayed.
 		bool readFrames(const char *filename);
 		
-		std::vector<std::shared_ptr<Packet::LogFrame> > frames;
+		LogReader log;
 		
 	public Q_SLOTS:
 		void updateViews();
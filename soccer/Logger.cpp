@@ -4,18 +4,39 @@
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 #include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
 #include <stdio.h>
 
 using namespace std;
 using namespace Packet;
 using namespace google::protobuf::io;
 
-Logger::Logger()
+// Maximum number of frames waiting to be written to disk.
+// At 60 frames per second this covers a disk stall of about 17 seconds.
+static const int WriteQueueSize = 1024;
+
+// How long the writer thread sleeps when there is nothing to write
+static const int WriterIdle_us = 10 * 1000;
+
+Logger::Logger(size_t historyBudget, size_t spillBudget):
+	_historyBudget(historyBudget),
+	_spillBudget(spillBudget),
+	_writer(this)
 {
 	_fd = -1;
-	_history.resize(100000);
+	_historyBytes = 0;
+	_spillBytes = 0;
 	_nextFrameNumber = 0;
-	_spaceUsed = sizeof(_history[0]) * _history.size();
+	
+	_stopWriter = false;
+	_queue.resize(WriteQueueSize);
+	_queueHead = 0;
+	_queueTail = 0;
+	_framesWritten = 0;
+	_framesDropped = 0;
+	_bytesWritten = 0;
+	_maxQueueDepth = 0;
 }
 
 Logger::~Logger()
@@ -25,94 +46,216 @@ Logger::~Logger()
 
 bool Logger::open(QString filename)
 {
+	close();
+	
+	int fd = creat(filename.toAscii(), 0666);
+	if (fd < 0)
+	{
+		printf("Can't create %s: %m\n", (const char *)filename.toAscii());
+		return false;
+	}
+	
 	QMutexLocker locker(&_mutex);
 	
-	if (_fd >= 0)
+	// Discard anything left over from a log that failed
+	while (_queueTail != _queueHead)
 	{
-		close();
+		_queue[_queueTail % _queue.size()].reset();
+		++_queueTail;
 	}
 	
-	_fd = creat(filename.toAscii(), 0666);
-	if (_fd < 0)
+	_framesWritten = 0;
+	_framesDropped = 0;
+	_bytesWritten = 0;
+	_maxQueueDepth = 0;
+	
+	if (!_chunkWriter.open(fd))
 	{
-		printf("Can't create %s: %m\n", (const char *)filename.toAscii());
+		printf("Can't write to %s: %m\n", (const char *)filename.toAscii());
+		::close(fd);
 		return false;
 	}
 	
 	_filename = filename;
+	_fd = fd;
+	
+	// close() has already waited for the previous writer to finish
+	_stopWriter = false;
+	_writer.start();
 	
 	return true;
 }
 
 void Logger::close()
 {
-	QMutexLocker locker(&_mutex);
-	if (_fd >= 0)
+	// Let the writer flush everything that was queued
+	_stopWriter = true;
+	_writer.wait();
+	
+	int fd = _fd.exchange(-1);
+	if (fd >= 0)
 	{
-		::close(_fd);
-		_fd = -1;
-		_filename = QString();
+		// Write the chunk index so the log can be opened without scanning
+		if (!_chunkWriter.close())
+		{
+			printf("Logger: Failed to finish log: %m\n");
+		}
+		::close(fd);
 	}
+	
+	QMutexLocker locker(&_mutex);
+	_filename = QString();
 }
 
 void Logger::addFrame(shared_ptr<LogFrame> frame)
 {
+	// This also caches the size of every submessage, so serializing the frame later doesn't
+	// have to compute it again.  It must happen before the writer thread can see the frame.
+	HistoryEntry entry;
+	entry.frame = frame;
+	entry.size = frame->ByteSize();
+	
+	// Frames that leave the history are destroyed after the mutex is released
+	vector<shared_ptr<LogFrame> > evicted;
+	
 	QMutexLocker locker(&_mutex);
 	
-	// Write this from to the file
+	// Queue this frame to be written to the file
 	if (_fd >= 0)
 	{
 		if (frame->IsInitialized())
 		{
-			uint32_t size = frame->ByteSize();
-			if (write(_fd, &size, sizeof(size)) != sizeof(size))
+			unsigned int head = _queueHead.load(memory_order_relaxed);
+			int depth = head - _queueTail.load(memory_order_acquire);
+			if (depth >= (int)_queue.size())
 			{
-				printf("Logger: Failed to write size, closing log: %m\n");
-				close();
-			} else if (!frame->SerializeToFileDescriptor(_fd))
-			{
-				printf("Logger: Failed to write frame, closing log: %m\n");
-				close();
+				// The writer is falling behind.  Don't wait for it.
+				++_framesDropped;
+			} else {
+				_queue[head % _queue.size()] = frame;
+				_queueHead.store(head + 1, memory_order_release);
+				
+				if (depth + 1 > _maxQueueDepth)
+				{
+					_maxQueueDepth = depth + 1;
+				}
 			}
 		} else {
 			printf("Logger: Not writing frame missing fields: %s\n", frame->InitializationErrorString().c_str());
 		}
 	}
 	
-	// Get the place in the circular buffer where we will store this frame
-	int i = _nextFrameNumber % _history.size();
+	_history.push_back(entry);
+	_historyBytes += entry.size;
+	++_nextFrameNumber;
 	
-	if (_history[i])
+	// Drop the oldest frames until the history fits in its budget, but always keep the newest
+	while (_historyBytes > _historyBudget && _history.size() > 1)
 	{
-		// Remove the space used by the old data
-		_spaceUsed -= _history[i]->SpaceUsed();
+		HistoryEntry &old = _history.front();
+		_historyBytes -= old.size;
+		
+		if (_spillBudget)
+		{
+			// Sizes were cached when the frame was added
+			_spill.push_back(string(old.size, 0));
+			old.frame->SerializeWithCachedSizesToArray((uint8_t *)&_spill.back()[0]);
+			_spillBytes += old.size;
+		}
+		
+		evicted.push_back(old.frame);
+		_history.pop_front();
 	}
 	
-	// Create a new LogFrame
-	_history[i] = frame;
+	while (_spillBytes > _spillBudget && !_spill.empty())
+	{
+		_spillBytes -= _spill.front().size();
+		_spill.pop_front();
+	}
 	
-	// Add space used by the new data
-	_spaceUsed += _history[i]->SpaceUsed();
+	locker.unlock();
+	evicted.clear();
+}
+
+void Logger::writerLoop()
+{
+	while (!_stopWriter && _fd >= 0)
+	{
+		if (!writeQueued())
+		{
+			// See Processor for why we can't use QThread::usleep()
+			::usleep(WriterIdle_us);
+		}
+	}
 	
-	// Go to the next frame
-	++_nextFrameNumber;
+	// Flush
+	while (_fd >= 0 && writeQueued())
+	{
+	}
+}
+
+bool Logger::writeQueued()
+{
+	unsigned int tail = _queueTail.load(memory_order_relaxed);
+	unsigned int head = _queueHead.load(memory_order_acquire);
+	if (tail == head)
+	{
+		return false;
+	}
+	
+	int n = 0;
+	bool ok = true;
+	for (; tail != head; ++tail, ++n)
+	{
+		shared_ptr<LogFrame> &frame = _queue[tail % _queue.size()];
+		ok = ok && _chunkWriter.addFrame(*frame);
+		frame.reset();
+	}
+	_queueTail.store(tail, memory_order_release);
+	
+	_bytesWritten = _chunkWriter.bytesWritten();
+	if (!ok)
+	{
+		printf("Logger: Failed to write frames, closing log: %m\n");
+		_chunkWriter.abandon();
+		::close(_fd.exchange(-1));
+		return false;
+	}
+	
+	_framesWritten += n;
+	return true;
+}
+
+Logger::WriteStats Logger::writeStats() const
+{
+	WriteStats stats;
+	stats.framesWritten = _framesWritten;
+	stats.framesDropped = _framesDropped;
+	stats.bytesWritten = _bytesWritten;
+	stats.queueDepth = _queueHead - _queueTail;
+	stats.maxQueueDepth = _maxQueueDepth;
+	return stats;
 }
 
 shared_ptr<LogFrame> Logger::lastFrame() const
 {
 	QMutexLocker locker(&_mutex);
-	return _history[(_nextFrameNumber - 1) % _history.size()];
+	if (_history.empty())
+	{
+		return shared_ptr<LogFrame>();
+	}
+	return _history.back().frame;
 }
 
 int Logger::getFrames(int start, vector<shared_ptr<LogFrame> > &frames) const
 {
+	// Spilled frames are copied out while locked and parsed after unlocking
+	vector<string> spilled;
+	
 	QMutexLocker locker(&_mutex);
 	
-	int minFrame = _nextFrameNumber - (int)_history.size();
-	if (minFrame < 0)
-	{
-		minFrame = 0;
-	}
+	int firstLive = _nextFrameNumber - (int)_history.size();
+	int minFrame = firstLive - (int)_spill.size();
 	
 	if (start < minFrame || start >= _nextFrameNumber)
 	{
@@ -126,9 +269,27 @@ int Logger::getFrames(int start, vector<shared_ptr<LogFrame> > &frames) const
 	}
 	
 	int n = start - end + 1;
-	for (int i = 0; i < n; ++i)
+	int live = 0;
+	for (; live < n && start - live >= firstLive; ++live)
 	{
-		frames[i] = _history[(start - i) % _history.size()];
+		frames[live] = _history[start - live - firstLive].frame;
+	}
+	for (int i = live; i < n; ++i)
+	{
+		spilled.push_back(_spill[start - i - minFrame]);
+	}
+	
+	locker.unlock();
+	
+	for (int i = live; i < n; ++i)
+	{
+		shared_ptr<LogFrame> frame = make_shared<LogFrame>();
+		if (frame->ParsePartialFromString(spilled[i - live]))
+		{
+			frames[i] = frame;
+		} else {
+			frames[i].reset();
+		}
 	}
 	
 	for (int i = n; i < (int)frames.size(); ++i)
@@ -1,7 +1,4 @@
-// This logger implements a circular buffer for recent history and writes all
-// frames to disk.
-//
-// _history is a circular buffer.
+// This logger keeps recent history in memory and writes all frames to disk.
 //
 // Consider a sequence number for each frame, where the first frame passed
 // to addFrame() has a sequence number of zero and the sequence number is one greater for
@@ -9,31 +6,71 @@
 //
 // _nextFrameNumber is the sequence number of the next frame to be stored by addFrame().
 //
-// lastFrame() returns the sequence number of the latest available frame.
+// lastFrameNumber() returns the sequence number of the latest available frame.
 // It returns -1 if no frames have been stored.
 //
-// You can get a copy of a frame by passing its sequence number to getFrame().
-// If the frame is too old to be in the circular buffer (or the sequence number is
-// beyond the most recent available) then getFrame() will return false.
+// You can get recent frames by passing a sequence number to getFrames().
+// Frames that are too old to be in the history are returned as null.
+//
+// History is limited by a budget in bytes instead of a number of frames.  Each frame is
+// charged its serialized size, which protobuf computes without reflection, so accounting
+// costs little even for frames full of raw vision and debug drawing.  The serialized size
+// is smaller than the in-memory size, so the budget is an estimate of memory use that
+// scales with what is really stored.
+//
+// Frames pushed out of the history can optionally be kept serialized in a second ring
+// (see spillBudget()).  They take much less memory there and are parsed again by getFrames().
 //
-// Frames are allocated as they are first needed.  The size of the circular buffer
-// limits total memory usage.
+// Writing to disk is done by a separate thread so addFrame() never blocks on I/O.
+// addFrame() puts frames in a bounded single-producer/single-consumer queue and the
+// writer thread drains it into a ChunkedLog, which writes compressed chunks of frames.
+// If the queue is full the frame is kept in history but not written to disk,
+// and this is counted in writeStats().
 
 #pragma once
 
 #include <protobuf/LogFrame.pb.h>
+#include <ChunkedLog.hpp>
 
 #include <QString>
 #include <QMutexLocker>
 #include <QMutex>
+#include <QThread>
 #include <vector>
+#include <deque>
+#include <string>
 #include <algorithm>
 #include <memory>
+#include <atomic>
+#include <stdint.h>
 
 class Logger
 {
 	public:
-		Logger();
+		/// Statistics for the disk writer
+		struct WriteStats
+		{
+			/// Frames written to disk
+			uint64_t framesWritten;
+			
+			/// Frames not written because the queue was full
+			uint64_t framesDropped;
+			
+			uint64_t bytesWritten;
+			
+			/// Frames currently waiting to be written
+			int queueDepth;
+			
+			/// Largest queueDepth seen since the log was opened
+			int maxQueueDepth;
+		};
+		
+		/// Default limit on the serialized size of frames kept in history
+		static const size_t DefaultHistoryBudget = 256 * 1024 * 1024;
+		
+		/// Keeps up to @historyBudget bytes of frames in history and up to @spillBudget bytes
+		/// of older frames serialized.
+		Logger(size_t historyBudget = DefaultHistoryBudget, size_t spillBudget = 0);
 		~Logger();
 		
 		bool open(QString filename);
@@ -43,14 +80,7 @@ class Logger
 		int numFrames() const
 		{
 			QMutexLocker locker(&_mutex);
-			return std::min(_nextFrameNumber, (int)_history.size());
-		}
-		
-		// Returns the size of the circular buffer
-		int maxFrames() const
-		{
-			QMutexLocker locker(&_mutex);
-			return _history.size();
+			return _history.size() + _spill.size();
 		}
 		
 		// Returns the sequence number of the earliest available frame.
@@ -62,7 +92,7 @@ class Logger
 			{
 				return -1;
 			} else {
-				return std::max(0, _nextFrameNumber - (int)_history.size());
+				return _nextFrameNumber - (int)(_history.size() + _spill.size());
 			}
 		}
 		
@@ -83,11 +113,24 @@ class Logger
 		// Returns the number of frames copied.
 		int getFrames(int start, std::vector<std::shared_ptr<Packet::LogFrame> > &frames) const;
 		
-		// Returns the amount of memory used by all LogFrames in the history.
-		int spaceUsed() const
+		// Returns the serialized size of all frames in the history and the spill ring
+		size_t spaceUsed() const
 		{
 			QMutexLocker locker(&_mutex);
-			return _spaceUsed;
+			return _historyBytes + _spillBytes;
+		}
+		
+		// Returns the limit on spaceUsed()
+		size_t budget() const
+		{
+			return _historyBudget + _spillBudget;
+		}
+		
+		// Limit on the size of frames kept serialized after they leave the history.
+		// Zero disables the spill ring.
+		size_t spillBudget() const
+		{
+			return _spillBudget;
 		}
 		
 		bool recording() const
@@ -102,24 +145,77 @@ class Logger
 			return _filename;
 		}
 		
+		WriteStats writeStats() const;
+		
 	private:
+		class WriterThread: public QThread
+		{
+			public:
+				WriterThread(Logger *logger): _logger(logger) {}
+				
+			protected:
+				virtual void run()
+				{
+					_logger->writerLoop();
+				}
+				
+				Logger *_logger;
+		};
+		
+		/// Body of the writer thread
+		void writerLoop();
+		
+		/// Writes all queued frames.  Returns false if the queue was empty.
+		/// Only called from the writer thread.
+		bool writeQueued();
+		
 		mutable QMutex _mutex;
 		
 		QString _filename;
 		
-		// Frame history.
-		// Increasing indices correspond to earlier times.
+		// Frame history, oldest first, with the serialized size of each frame.
 		// This must only be accessed while _mutex is locked.
 		//
 		// It is not safe to modify a single std::shared_ptr from multiple threads,
 		// but after it is copied the copies can be used and destroyed freely in different threads.
-		std::vector<std::shared_ptr<Packet::LogFrame> > _history;
+		struct HistoryEntry
+		{
+			std::shared_ptr<Packet::LogFrame> frame;
+			size_t size;
+		};
+		std::deque<HistoryEntry> _history;
+		size_t _historyBytes;
+		const size_t _historyBudget;
+		
+		// Serialized frames from before the oldest frame in _history, oldest first
+		std::deque<std::string> _spill;
+		size_t _spillBytes;
+		const size_t _spillBudget;
 		
 		// Sequence number of the next frame to be written
 		int _nextFrameNumber;
 		
-		int _spaceUsed;
+		// File descriptor for log file.
+		// Only the writer thread writes to it while it is running.
+		std::atomic<int> _fd;
+		
+		WriterThread _writer;
+		
+		// Tells the writer thread to flush the queue and exit
+		std::atomic<bool> _stopWriter;
+		
+		// Frames waiting to be written.
+		// Only addFrame() advances _queueHead and only the writer thread advances _queueTail.
+		// Both count up forever and are reduced modulo the queue size to index it.
+		std::vector<std::shared_ptr<Packet::LogFrame> > _queue;
+		std::atomic<unsigned int> _queueHead;
+		std::atomic<unsigned int> _queueTail;
+		
+		// Only used by the writer thread while it is running
+		ChunkedLog::Writer _chunkWriter;
 		
-		// File descriptor for log file
-		int _fd;
+		std::atomic<uint64_t> _framesWritten;
+		std::atomic<uint64_t> _framesDropped;
+		std::atomic<uint64_t> _bytesWritten;
+		std::atomic<int> _maxQueueDepth;
 };
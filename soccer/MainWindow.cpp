@@ -50,7 +50,7 @@ MainWindow::MainWindow(QWidget *parent):
 	_doubleFrameNumber = -1;
 	
 	_lastUpdateTime = timestamp();
-	_history.resize(2 * 60);
+	_history.resize(Processor::Snapshot::HistorySize);
 	
 	_ui.setupUi(this);
 	_ui.fieldView->history(&_history);
@@ -185,15 +185,19 @@ void MainWindow::live(bool value)
 
 void MainWindow::updateViews()
 {
-	int manual =_processor->manualID();
-	if ((manual >= 0 || _ui.manualID->isEnabled()) && !_processor->joystickValid())
+	// Everything read from the processor every frame comes from this snapshot,
+	// so while live the GUI never waits for the processing loop or the logger.
+	const Processor::Snapshot &snap = _processor->snapshot();
+	
+	int manual = snap.manualID;
+	if ((manual >= 0 || _ui.manualID->isEnabled()) && !snap.joystickValid)
 	{
 		// Joystick is gone - turn off manual control
 		_ui.manualID->setCurrentIndex(0);
 		_processor->manualID(-1);
 		_ui.manualID->setEnabled(false);
 		_ui.tabWidget->setTabEnabled(2, false);
-	} else if (!_ui.manualID->isEnabled() && _processor->joystickValid())
+	} else if (!_ui.manualID->isEnabled() && snap.joystickValid)
 	{
 		// Joystick reconnected
 		_ui.manualID->setEnabled(true);
@@ -201,7 +205,7 @@ void MainWindow::updateViews()
 		_ui.tabWidget->setTabEnabled(2, true);
 	}
 	if(manual >= 0) {
-		JoystickControlValues vals = _processor->joystickControlValues();
+		const JoystickControlValues &vals = snap.joystick;
 		_ui.joystickBodyXLabel->setText(tr("%1").arg(vals.bodyX));
 		_ui.joystickBodyYLabel->setText(tr("%1").arg(vals.bodyY));
 		_ui.joystickBodyWLabel->setText(tr("%1").arg(vals.bodyW));
@@ -224,17 +228,27 @@ void MainWindow::updateViews()
 		_updateCount = 0;
 		
 		_viewFPS->setText(QString("View: %1 fps").arg(framerate, 0, 'f', 1));
-		_procFPS->setText(QString("Proc: %1 fps").arg(_processor->framerate(), 0, 'f', 1));
+		_procFPS->setText(QString("Proc: %1 fps").arg(snap.framerate, 0, 'f', 1));
+		_procFPS->setToolTip(QString("Vision to radio: %1 ms").arg(snap.status.visionToRadioLatency / 1000.0, 0, 'f', 1));
+		
+		_logMemory->setText(QString("Log: %1 frames %2/%3 MiB").arg(
+			QString::number(snap.logFrames),
+			QString::number((snap.logSpaceUsed + 512 * 1024) / (1024 * 1024)),
+			QString::number((snap.logBudget + 512 * 1024) / (1024 * 1024))
+		));
 		
-		_logMemory->setText(QString("Log: %1/%2 %3 kiB").arg(
-			QString::number(_processor->logger().numFrames()),
-			QString::number(_processor->logger().maxFrames()),
-			QString::number((_processor->logger().spaceUsed() + 512) / 1024)
+		const Logger::WriteStats &ws = snap.writeStats;
+		_logMemory->setToolTip(QString("Log Memory Usage\nWritten: %1 frames, %2 kiB\nQueued: %3 (max %4)\nDropped: %5").arg(
+			QString::number(ws.framesWritten),
+			QString::number((ws.bytesWritten + 512) / 1024),
+			QString::number(ws.queueDepth),
+			QString::number(ws.maxQueueDepth),
+			QString::number(ws.framesDropped)
 		));
 	}
 	
 	// Advance log playback time
-	int liveFrameNumber = _processor->logger().lastFrameNumber();
+	int liveFrameNumber = snap.logLastFrame;
 	if (_live)
 	{
 		_doubleFrameNumber = liveFrameNumber;
@@ -242,8 +256,8 @@ void MainWindow::updateViews()
 		double rate = _ui.playbackRate->value();
 		_doubleFrameNumber += rate / framerate;
 		
-		int minFrame = _processor->logger().firstFrameNumber();
-		int maxFrame = _processor->logger().lastFrameNumber();
+		int minFrame = snap.logFirstFrame;
+		int maxFrame = snap.logLastFrame;
 		if (_doubleFrameNumber < minFrame)
 		{
 			_doubleFrameNumber = minFrame;
@@ -253,8 +267,13 @@ void MainWindow::updateViews()
 		}
 	}
 	
-	// Read recent history from the log
-	_processor->logger().getFrames(frameNumber(), _history);
+	// Live history comes with the snapshot.  Only reading older frames needs the logger.
+	if (_live)
+	{
+		_history = snap.history;
+	} else {
+		_processor->logger().getFrames(frameNumber(), _history);
+	}
 	
 	// Update field view
 	_ui.fieldView->update();
@@ -264,11 +283,11 @@ void MainWindow::updateViews()
 	_ui.logStop->setEnabled(_live);
 	
 	// Update status indicator
-	updateStatus();
+	updateStatus(snap);
 	
 	// Check if any debug layers have been added
 	// (layers should never be removed)
-	const std::shared_ptr<LogFrame> liveFrame = _processor->logger().lastFrame();
+	const std::shared_ptr<LogFrame> &liveFrame = snap.lastFrame;
 	if (liveFrame && liveFrame->debug_layers_size() > _ui.debugLayers->count())
 	{
 		// Add the missing layers and turn them on
@@ -330,7 +349,8 @@ void MainWindow::updateViews()
 		_ui.behaviorTree->setPlainText(QString::fromStdString(currentFrame->behavior_tree()));
 	}
 
-	if(std::time(0) - (_processor->refereeModule()->received_time/1000000) > 1)
+	const NewRefereeModule::Status &ref = snap.referee;
+	if(std::time(0) - (ref.receivedTime/1000000) > 1)
 	{
 		_ui.fastHalt->setEnabled(true);
 		_ui.fastStop->setEnabled(true);
@@ -349,31 +369,31 @@ void MainWindow::updateViews()
 		_ui.fastKickoffYellow->setEnabled(false);
 	}
 
-	_ui.refStage->setText(NewRefereeModuleEnums::stringFromStage(_processor->refereeModule()->stage).c_str());
-	_ui.refCommand->setText(NewRefereeModuleEnums::stringFromCommand(_processor->refereeModule()->command).c_str());
+	_ui.refStage->setText(NewRefereeModuleEnums::stringFromStage(ref.stage).c_str());
+	_ui.refCommand->setText(NewRefereeModuleEnums::stringFromCommand(ref.command).c_str());
 
-	_ui.refTimeLeft->setText(tr("%1 ms").arg(_processor->refereeModule()->stage_time_left));
+	_ui.refTimeLeft->setText(tr("%1 ms").arg(ref.stageTimeLeft));
 
-	_ui.refBlueName->setText(_processor->refereeModule()->blue_info.name.c_str());
-	_ui.refBlueScore->setText(tr("%1").arg(_processor->refereeModule()->blue_info.score));
-	_ui.refBlueRedCards->setText(tr("%1").arg(_processor->refereeModule()->blue_info.red_cards));
-	_ui.refBlueYellowCards->setText(tr("%1").arg(_processor->refereeModule()->blue_info.yellow_cards));
-	_ui.refBlueTimeoutsLeft->setText(tr("%1").arg(_processor->refereeModule()->blue_info.timeouts_left));
-	_ui.refBlueGoalie->setText(tr("%1").arg(_processor->refereeModule()->blue_info.goalie));
+	_ui.refBlueName->setText(ref.blueInfo.name.c_str());
+	_ui.refBlueScore->setText(tr("%1").arg(ref.blueInfo.score));
+	_ui.refBlueRedCards->setText(tr("%1").arg(ref.blueInfo.red_cards));
+	_ui.refBlueYellowCards->setText(tr("%1").arg(ref.blueInfo.yellow_cards));
+	_ui.refBlueTimeoutsLeft->setText(tr("%1").arg(ref.blueInfo.timeouts_left));
+	_ui.refBlueGoalie->setText(tr("%1").arg(ref.blueInfo.goalie));
 	
-	_ui.refYellowName->setText(_processor->refereeModule()->yellow_info.name.c_str());
-	_ui.refYellowScore->setText(tr("%1").arg(_processor->refereeModule()->yellow_info.score));
-	_ui.refYellowRedCards->setText(tr("%1").arg(_processor->refereeModule()->yellow_info.red_cards));
-	_ui.refYellowYellowCards->setText(tr("%1").arg(_processor->refereeModule()->yellow_info.yellow_cards));
-	_ui.refYellowTimeoutsLeft->setText(tr("%1").arg(_processor->refereeModule()->yellow_info.timeouts_left));
-	_ui.refYellowGoalie->setText(tr("%1").arg(_processor->refereeModule()->yellow_info.goalie));
+	_ui.refYellowName->setText(ref.yellowInfo.name.c_str());
+	_ui.refYellowScore->setText(tr("%1").arg(ref.yellowInfo.score));
+	_ui.refYellowRedCards->setText(tr("%1").arg(ref.yellowInfo.red_cards));
+	_ui.refYellowYellowCards->setText(tr("%1").arg(ref.yellowInfo.yellow_cards));
+	_ui.refYellowTimeoutsLeft->setText(tr("%1").arg(ref.yellowInfo.timeouts_left));
+	_ui.refYellowGoalie->setText(tr("%1").arg(ref.yellowInfo.goalie));
 
 	// We restart this timer repeatedly instead of using a single shot timer in order
 	// to guarantee a minimum time between redraws.  This will limit the CPU usage on a fast computer.
 	updateTimer.start(20);
 }
 
-void MainWindow::updateStatus()
+void MainWindow::updateStatus(const Processor::Snapshot &snap)
 {
 	// Guidelines:
 	//    Status_Fail is used for severe, usually external, errors such as hardware or network failures.
@@ -394,7 +414,7 @@ void MainWindow::updateStatus()
 	bool sim = _processor->simulation();
 	
 	// Get processing thread status
-	Processor::Status ps = _processor->status();
+	const Processor::Status &ps = snap.status;
 	uint64_t curTime = timestamp();
 	
 	// Determine if we are receiving packets from an external referee
@@ -424,7 +444,7 @@ void MainWindow::updateStatus()
 		return;
 	}
 	
-	if (_processor->manualID() >= 0)
+	if (snap.manualID >= 0)
 	{
 		// Mixed auto/manual control
 		status("MANUAL", Status_Warning);
@@ -479,7 +499,7 @@ void MainWindow::updateStatus()
 	
 	//FIXME - Can we validate or flag the playbook?
 	
-	if (!sim && !_processor->logger().recording())
+	if (!sim && !snap.recording)
 	{
 		// We should record logs during competition
 		status("NOT RECORDING", Status_Warning);
@@ -862,7 +882,14 @@ void MainWindow::on_debugLayers_itemChanged(QListWidgetItem* item)
 	int layer = item->data(Qt::UserRole).toInt();
 	if (layer >= 0)
 	{
-		_ui.fieldView->layerVisible(layer, item->checkState() == Qt::Checked);
+		bool visible = item->checkState() == Qt::Checked;
+		_ui.fieldView->layerVisible(layer, visible);
+		
+		// Don't spend time drawing (or space logging) layers nobody is looking at
+		if (_processor)
+		{
+			_processor->state()->debugLayerEnabled(layer, visible);
+		}
 	}
 	_ui.fieldView->update();
 }
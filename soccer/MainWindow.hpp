@@ -151,7 +151,7 @@ class MainWindow : public QMainWindow
 		void on_fastKickoffYellow_clicked();
 		
 	private:
-		void updateStatus();
+		void updateStatus(const Processor::Snapshot &snap);
 		
 		typedef enum
 		{
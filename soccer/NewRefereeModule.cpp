@@ -94,6 +94,17 @@ void NewRefereeModule::getPackets(std::vector<NewRefereePacket *> &packets)
 	_mutex.unlock();
 }
 
+void NewRefereeModule::getStatus(Status &status)
+{
+	QMutexLocker locker(&_mutex);
+	status.stage = stage;
+	status.command = command;
+	status.receivedTime = received_time;
+	status.stageTimeLeft = stage_time_left;
+	status.yellowInfo = yellow_info;
+	status.blueInfo = blue_info;
+}
+
 void NewRefereeModule::run()
 {
 	QUdpSocket socket;
@@ -129,7 +140,10 @@ void NewRefereeModule::run()
 
 		NewRefereePacket *packet = new NewRefereePacket;
 		packet->receivedTime = timestamp();
-		this->received_time = packet->receivedTime;
+		{
+			QMutexLocker locker(&_mutex);
+			this->received_time = packet->receivedTime;
+		}
 		if(!packet->wrapper.ParseFromArray(buf, size))
 		{
 			fprintf(stderr, "NewRefereeModule: got bad packet of %d bytes from %s:%d\n", (int)size, (const char *)host.toString().toAscii(), port);
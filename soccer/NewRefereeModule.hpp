@@ -113,6 +113,22 @@ public:
 class NewRefereeModule: public QThread
 {
 public:
+	/// The fields the GUI shows, copied together so they come from the same packet
+	struct Status
+	{
+		Status(): stage(NewRefereeModuleEnums::NORMAL_FIRST_HALF_PRE), command(NewRefereeModuleEnums::HALT),
+			receivedTime(0), stageTimeLeft(0)
+		{
+		}
+
+		NewRefereeModuleEnums::Stage stage;
+		NewRefereeModuleEnums::Command command;
+		uint64_t receivedTime;
+		int stageTimeLeft;
+		TeamInfo yellowInfo;
+		TeamInfo blueInfo;
+	};
+
 	NewRefereeModule(SystemState &state);
 	~NewRefereeModule();
 
@@ -120,6 +136,9 @@ public:
 
 	void getPackets(std::vector<NewRefereePacket *> &packets);
 
+	/// Copies the latest referee state while the receiving thread can't change it
+	void getStatus(Status &status);
+
 	bool kicked() {
 		return _kickDetectState == Kicked;
 	}
@@ -20,6 +20,7 @@
 
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
+#include <algorithm>
 
 #include <protobuf/messages_robocup_ssl_detection.pb.h>
 #include <protobuf/messages_robocup_ssl_wrapper.pb.h>
@@ -37,6 +38,14 @@ using namespace google::protobuf;
 
 static const uint64_t Command_Latency = 0;
 
+// In vision-triggered mode, the shortest time between frames as a fraction of the frame period
+static const float VisionMinSpacing = 0.75;
+
+// In vision-triggered mode, how long to wait after the first packet of a frame for the other cameras
+static const int VisionSettle_us = 2000;
+
+const int Processor::Snapshot::HistorySize;
+
 RobotConfig *Processor::robotConfig2008;
 RobotConfig *Processor::robotConfig2011;
 std::vector<RobotStatus*> Processor::robotStatuses; ///< FIXME: verify that this is correct
@@ -52,7 +61,7 @@ void Processor::createConfiguration(Configuration *cfg)
 	}
 }
 
-Processor::Processor(bool sim) : _loopMutex(QMutex::Recursive)
+Processor::Processor(bool sim, bool lockstep) : _loopMutex(QMutex::Recursive)
 {
 	_running = true;
 	_framePeriod = 1000000 / 60;
@@ -65,7 +74,17 @@ Processor::Processor(bool sim) : _loopMutex(QMutex::Recursive)
 	_useOpponentHalf = true;
 
 	_simulation = sim;
+	_lockstep = sim && lockstep;
+	_visionTriggered = false;
 	_radio = 0;
+
+	if (_lockstep)
+	{
+		// Must be installed before any other thread reads the time
+		_clock.set(systemTimestamp());
+		setTimeSource(&_clock);
+	}
+
 	_joystick = new Joystick();
 	
 	// Initialize team-space transformation
@@ -89,6 +108,11 @@ Processor::~Processor()
 	//DEBUG - This is unnecessary, but lets us determine which one breaks.
 	//_refereeModule.reset();
 	_gameplayModule.reset();
+
+	if (_lockstep)
+	{
+		setTimeSource(0);
+	}
 }
 
 void Processor::stop()
@@ -162,18 +186,33 @@ JoystickControlValues Processor::joystickControlValues() {
 	return _joystick->getJoystickControlValues();
 }
 
-void Processor::runModels(const vector<const SSL_DetectionFrame *> &detectionFrames)
+bool Processor::excludedByHalf(float x) const
+{
+	//FIXME - OMG too many terms
+	return (!_state.logFrame->use_opponent_half() && ((_defendPlusX && x < 0) || (!_defendPlusX && x > 0))) ||
+			(!_state.logFrame->use_our_half() && ((_defendPlusX && x > 0) || (!_defendPlusX && x < 0)));
+}
+
+void Processor::runModels(const vector<const SSL_DetectionFrame *> &detectionFrames, const vector<uint64_t> &captureTimes)
 {
 	vector<BallObservation> ballObservations;
 	
-	BOOST_FOREACH(const SSL_DetectionFrame* frame, detectionFrames)
+	// Robot observations from all cameras, to be given to the filters in order of capture time
+	vector<pair<Robot *, RobotObservation> > robotObservations;
+	
+	for (unsigned int f = 0; f < detectionFrames.size(); ++f)
 	{
-		uint64_t time = frame->t_capture() * SecsToTimestamp;
+		const SSL_DetectionFrame *frame = detectionFrames[f];
+		uint64_t time = captureTimes[f];
 		
-		// Add ball observations
+		// Add ball observations, ignoring the excluded half of the field
 		ballObservations.reserve(ballObservations.size() + frame->balls().size());
 		BOOST_FOREACH(const SSL_DetectionBall &ball, frame->balls())
 		{
+			if (excludedByHalf(ball.x()))
+			{
+				continue;
+			}
 			ballObservations.push_back(BallObservation(_worldToTeam * Point(ball.x() / 1000, ball.y() / 1000), time));
 		}
 		
@@ -181,30 +220,49 @@ void Processor::runModels(const vector<const SSL_DetectionFrame *> &detectionFra
 		const RepeatedPtrField<SSL_DetectionRobot> &selfRobots = _blueTeam ? frame->robots_blue() : frame->robots_yellow();
 		BOOST_FOREACH(const SSL_DetectionRobot &robot, selfRobots)
 		{
+			if (excludedByHalf(robot.x()))
+			{
+				continue;
+			}
 			float angleRad = fixAngleRadians(robot.orientation() + _teamAngle);
 			RobotObservation obs(_worldToTeam * Point(robot.x() / 1000, robot.y() / 1000), angleRad, time, frame->frame_number());
 			obs.source = frame->camera_id();
 			unsigned int id = robot.robot_id();
 			if (id < _state.self.size())
 			{
-				_state.self[id]->filter()->update(&obs);
+				robotObservations.push_back(make_pair((Robot *)_state.self[id], obs));
 			}
 		}
 		
 		const RepeatedPtrField<SSL_DetectionRobot> &oppRobots = _blueTeam ? frame->robots_yellow() : frame->robots_blue();
 		BOOST_FOREACH(const SSL_DetectionRobot &robot, oppRobots)
 		{
+			if (excludedByHalf(robot.x()))
+			{
+				continue;
+			}
 			float angleRad = fixAngleRadians(robot.orientation() + _teamAngle);
 			RobotObservation obs(_worldToTeam * Point(robot.x() / 1000, robot.y() / 1000), angleRad, time, frame->frame_number());
 			obs.source = frame->camera_id();
 			unsigned int id = robot.robot_id();
 			if (id < _state.opp.size())
 			{
-				_state.opp[id]->filter()->update(&obs);
+				robotObservations.push_back(make_pair((Robot *)_state.opp[id], obs));
 			}
 		}
 	}
 	
+	// Cameras are not synchronized, so frames may arrive out of order
+	stable_sort(robotObservations.begin(), robotObservations.end(),
+		[](const pair<Robot *, RobotObservation> &a, const pair<Robot *, RobotObservation> &b)
+		{
+			return a.second < b.second;
+		});
+	for (unsigned int i = 0; i < robotObservations.size(); ++i)
+	{
+		robotObservations[i].first->filter()->update(&robotObservations[i].second);
+	}
+	
 	_ballTracker->run(ballObservations, &_state);
 	
 	BOOST_FOREACH(Robot *robot, _state.self)
@@ -233,7 +291,77 @@ void Processor::run()
 	//main loop
 	while (_running)
 	{
+		// Read vision packets
+		vector<VisionPacket *> visionPackets;
+		if (_lockstep)
+		{
+			// Each simulator step sends one vision frame, so wait for it and
+			// advance the clock to its capture time instead of sleeping.
+			// Time out once in a while so the thread has a chance to exit.
+			if (!vision.waitForPackets(500))
+			{
+				continue;
+			}
+			
+			vision.getPackets(visionPackets);
+			BOOST_FOREACH(VisionPacket *packet, visionPackets)
+			{
+				if (packet->wrapper.has_detection())
+				{
+					uint64_t t = packet->wrapper.detection().t_sent() * SecsToTimestamp;
+					if (t > _clock.now())
+					{
+						_clock.set(t);
+					}
+				}
+			}
+			
+			// Packets were received at the simulated time they were sent
+			BOOST_FOREACH(VisionPacket *packet, visionPackets)
+			{
+				packet->receivedTime = _clock.now();
+			}
+		} else if (_visionTriggered)
+		{
+			// Start the frame when vision arrives, but only once per vision frame.  Each camera sends
+			// its own packets and they aren't synchronised, so starting on every packet would run
+			// everything once per camera.
+			//
+			// Frames are spaced at least VisionMinSpacing apart, and after the first packet the other
+			// cameras get VisionSettle_us to deliver theirs.  Don't wait past the end of a normal
+			// frame period so everything else keeps running if vision stops.
+			int64_t spacing_us = (int64_t)(curStatus.lastLoopTime + _framePeriod * VisionMinSpacing) - (int64_t)timestamp();
+			if (spacing_us > 0)
+			{
+				::usleep(spacing_us);
+			}
+			
+			int64_t remaining_us = (int64_t)(curStatus.lastLoopTime + _framePeriod) - (int64_t)timestamp();
+			if (remaining_us > 0 && vision.waitForPackets((remaining_us + 999) / 1000))
+			{
+				::usleep(VisionSettle_us);
+			}
+			vision.getPackets(visionPackets);
+		} else {
+			vision.getPackets(visionPackets);
+		}
+		
+		// Oldest vision packet used in this frame, for measuring latency
+		uint64_t firstVisionTime = 0;
+		BOOST_FOREACH(VisionPacket *packet, visionPackets)
+		{
+			if (!firstVisionTime || packet->receivedTime < firstVisionTime)
+			{
+				firstVisionTime = packet->receivedTime;
+			}
+		}
+		
 		uint64_t startTime = timestamp();
+		
+		// Stage timing for this frame
+		uint64_t frameStart = ScopedTimer::now();
+		uint32_t visionTime = 0, modelsTime = 0, refereeTime = 0, motionTime = 0, loggingTime = 0, radioTime = 0;
+		
 		int delta_us = startTime - curStatus.lastLoopTime;
 		_framerate = 1000000.0 / delta_us;
 		curStatus.lastLoopTime = startTime;
@@ -290,65 +418,32 @@ void Processor::run()
 		////////////////
 		// Inputs
 		
-		// Read vision packets
+		// Handle vision packets
 		vector<const SSL_DetectionFrame *> detectionFrames;
-		vector<VisionPacket *> visionPackets;
-		vision.getPackets(visionPackets);
+		vector<uint64_t> captureTimes;
+		uint64_t visionStart = ScopedTimer::now();
 		BOOST_FOREACH(VisionPacket *packet, visionPackets)
 		{
+			// Move the parsed packet into the log instead of copying it.
+			// The log keeps the packet exactly as received, so corrections are applied in runModels.
+			// The log owns its wrappers for as long as it keeps the frame, so this still allocates
+			// one wrapper per packet.
 			SSL_WrapperPacket *log = _state.logFrame->add_raw_vision();
-			log->CopyFrom(packet->wrapper);
+			log->Swap(&packet->wrapper);
 			
 			curStatus.lastVisionTime = packet->receivedTime;
-			if (packet->wrapper.has_detection())
+			if (log->has_detection())
 			{
-				SSL_DetectionFrame *det = packet->wrapper.mutable_detection();
+				const SSL_DetectionFrame *det = &log->detection();
 				
 				//FIXME - Account for network latency
 				double rt = packet->receivedTime / 1000000.0;
-				det->set_t_capture(rt - det->t_sent() + det->t_capture());
-				det->set_t_sent(rt);
-				
-				// Remove balls on the excluded half of the field
-				google::protobuf::RepeatedPtrField<SSL_DetectionBall> *balls = det->mutable_balls();
-				for (int i = 0; i < balls->size(); ++i)
-				{
-					float x = balls->Get(i).x();
-					//FIXME - OMG too many terms
-					if ((!_state.logFrame->use_opponent_half() && ((_defendPlusX && x < 0) || (!_defendPlusX && x > 0))) ||
-							(!_state.logFrame->use_our_half() && ((_defendPlusX && x > 0) || (!_defendPlusX && x < 0))))
-					{
-						balls->SwapElements(i, balls->size() - 1);
-						balls->RemoveLast();
-						--i;
-					}
-				}
-				
-				// Remove robots on the excluded half of the field
-				google::protobuf::RepeatedPtrField<SSL_DetectionRobot> *robots[2] =
-				{
-					det->mutable_robots_yellow(),
-					det->mutable_robots_blue()
-				};
-				
-				for (int team = 0; team < 2; ++team)
-				{
-					for (int i = 0; i < robots[team]->size(); ++i)
-					{
-						float x = robots[team]->Get(i).x();
-						if ((!_state.logFrame->use_opponent_half() && ((_defendPlusX && x < 0) || (!_defendPlusX && x > 0))) ||
-								(!_state.logFrame->use_our_half() && ((_defendPlusX && x > 0) || (!_defendPlusX && x < 0))))
-						{
-							robots[team]->SwapElements(i, robots[team]->size() - 1);
-							robots[team]->RemoveLast();
-							--i;
-						}
-					}
-				}
-				
+				captureTimes.push_back((rt - det->t_sent() + det->t_capture()) * SecsToTimestamp);
 				detectionFrames.push_back(det);
 			}
 		}
+		vision.releasePackets(visionPackets);
+		visionTime = ScopedTimer::now() - visionStart;
 		
 		// Read radio reverse packets
 		_radio->receive();
@@ -374,34 +469,46 @@ void Processor::run()
 		
 		_joystick->update();
 		
-		runModels(detectionFrames);
+		{
+			ScopedTimer t(modelsTime);
+			runModels(detectionFrames, captureTimes);
+		}
 
 		// Update gamestate w/ referee data
-		_refereeModule->updateGameState(blueTeam());
-		_refereeModule->spinKickWatcher();
+		{
+			ScopedTimer t(refereeTime);
+			_refereeModule->updateGameState(blueTeam());
+			_refereeModule->spinKickWatcher();
+		}
 		
+		// GameplayModule records its own timing
 		if (_gameplayModule)
 		{
 			_gameplayModule->run();
 		}
 
 		// Run velocity controllers
-		BOOST_FOREACH(OurRobot *robot, _state.self)
 		{
-			if (robot->visible)
+			ScopedTimer t(motionTime);
+			BOOST_FOREACH(OurRobot *robot, _state.self)
 			{
-				if ((_manualID >= 0 && (int)robot->shell() == _manualID) || _state.gameState.halt())
+				if (robot->visible)
 				{
-					robot->motionControl()->stopped();
-				} else {
-					robot->motionControl()->run();	
-				}	
+					if ((_manualID >= 0 && (int)robot->shell() == _manualID) || _state.gameState.halt())
+					{
+						robot->motionControl()->stopped();
+					} else {
+						robot->motionControl()->run();	
+					}	
+				}
 			}
 		}
 
 		////////////////
 		// Store logging information
 		
+		uint64_t loggingStart = ScopedTimer::now();
+		
 		// Debug layers
 		const QStringList &layers = _state.debugLayers();
 		BOOST_FOREACH(const QString &str, layers)
@@ -423,6 +530,9 @@ void Processor::run()
 				// log->set_cmd_w(r->cmd_w);
 				log->set_shell(r->shell());
 				log->set_angle(r->angle);
+				log->set_planned_frames(r->plannedFrames());
+				log->set_reused_frames(r->reusedFrames());
+				log->set_straight_frames(r->straightFrames());
 				
 				if (r->radioRx().has_kicker_voltage())
 				{
@@ -484,15 +594,65 @@ void Processor::run()
 			*log->mutable_vel() = _state.ball.vel;
 		}
 		
+		loggingTime = ScopedTimer::now() - loggingStart;
+		
 		////////////////
 		// Outputs
 		
 		// Send motion commands to the robots
-		sendRadioData();
+		{
+			ScopedTimer t(radioTime);
+			sendRadioData();
+		}
+		
+		if (firstVisionTime)
+		{
+			uint64_t sentTime = timestamp();
+			int latency = sentTime > firstVisionTime ? sentTime - firstVisionTime : 0;
+			_state.logFrame->set_vision_to_radio_latency(latency);
+			curStatus.visionToRadioLatency = latency;
+		}
 
+		Packet::LogFrame::Timing *timing = _state.logFrame->mutable_timing();
+		timing->set_vision(visionTime);
+		timing->set_models(modelsTime);
+		timing->set_referee(refereeTime);
+		timing->set_motion_control(motionTime);
+		timing->set_logging(loggingTime);
+		timing->set_radio(radioTime);
+		timing->set_total(ScopedTimer::now() - frameStart);
+		
 		// Write to the log
 		_logger.addFrame(_state.logFrame);
 		
+		// Publish what the GUI needs so it doesn't have to lock anything
+		Snapshot &snap = _snapshot.back();
+		snap.status = curStatus;
+		snap.framerate = _framerate;
+		snap.manualID = _manualID;
+		snap.joystickValid = _joystick->valid();
+		
+		// The back buffer holds an older frame, so this must be reset too
+		snap.joystick = _manualID >= 0 ? _joystick->getJoystickControlValues() : JoystickControlValues();
+		snap.logFrames = _logger.numFrames();
+		snap.logFirstFrame = _logger.firstFrameNumber();
+		snap.logLastFrame = _logger.lastFrameNumber();
+		snap.logSpaceUsed = _logger.spaceUsed();
+		snap.logBudget = _logger.budget();
+		snap.recording = _logger.recording();
+		snap.writeStats = _logger.writeStats();
+		snap.lastFrame = _state.logFrame;
+		
+		_recentFrames.push_front(_state.logFrame);
+		if ((int)_recentFrames.size() > Snapshot::HistorySize)
+		{
+			_recentFrames.pop_back();
+		}
+		std::copy(_recentFrames.begin(), _recentFrames.end(), snap.history.begin());
+		
+		_refereeModule->getStatus(snap.referee);
+		_snapshot.publish();
+		
 		_loopMutex.unlock();
 		
 		// Store processing loop status
@@ -505,7 +665,10 @@ void Processor::run()
 		
 		uint64_t endTime = timestamp();
 		int lastFrameTime = endTime - startTime;
-		if (lastFrameTime < _framePeriod)
+		if (_lockstep || _visionTriggered)
+		{
+			// The next vision packet paces the loop
+		} else if (lastFrameTime < _framePeriod)
 		{
 			// Use system usleep, not QThread::usleep.
 			//
@@ -7,18 +7,21 @@
 #include <QMutex>
 #include <QMutexLocker>
 
+#include <deque>
+
 #include <protobuf/LogFrame.pb.h>
 #include <Logger.hpp>
 #include <Geometry2d/TransformMatrix.hpp>
 #include <SystemState.hpp>
 #include <modeling/RobotFilter.hpp>
 #include <NewRefereeModule.hpp>
+#include <Utils.hpp>
+#include <TripleBuffer.hpp>
+#include <Joystick.hpp>
 #include "VisionReceiver.hpp"
 
 class Configuration;
 class RobotStatus;
-class Joystick;
-struct JoystickControlValues;
 class Radio;
 class BallTracker;
 
@@ -91,17 +94,76 @@ class Processor: public QThread
 				lastVisionTime = 0;
 				lastRefereeTime = 0;
 				lastRadioRxTime = 0;
+				visionToRadioLatency = 0;
 			}
 			
 			uint64_t lastLoopTime;
 			uint64_t lastVisionTime;
 			uint64_t lastRefereeTime;
 			uint64_t lastRadioRxTime;
+			
+			/// Microseconds from vision to radio in the most recent frame that had vision
+			int visionToRadioLatency;
+		};
+		
+		/// Everything the GUI shows every frame, published once per frame so the GUI can read it
+		/// without locking anything the processing loop uses.
+		struct Snapshot
+		{
+			Snapshot()
+			{
+				framerate = 0;
+				manualID = -1;
+				joystickValid = false;
+				joystick = JoystickControlValues();
+				logFrames = 0;
+				logFirstFrame = -1;
+				logLastFrame = -1;
+				logSpaceUsed = 0;
+				logBudget = 0;
+				recording = false;
+				writeStats = Logger::WriteStats();
+				history.resize(HistorySize);
+			}
+			
+			/// Number of recent frames in history
+			static const int HistorySize = 2 * 60;
+			
+			Status status;
+			float framerate;
+			
+			int manualID;
+			bool joystickValid;
+			
+			/// All zero unless manualID >= 0
+			JoystickControlValues joystick;
+			
+			/// See the Logger accessors with the same names
+			int logFrames;
+			int logFirstFrame;
+			int logLastFrame;
+			size_t logSpaceUsed;
+			size_t logBudget;
+			bool recording;
+			Logger::WriteStats writeStats;
+			
+			/// The frame most recently given to the logger
+			std::shared_ptr<Packet::LogFrame> lastFrame;
+			
+			/// The most recent frames, newest first, so the live view doesn't have to read the logger.
+			/// Always HistorySize long, with null pointers before enough frames have been logged.
+			std::vector<std::shared_ptr<Packet::LogFrame> > history;
+			
+			NewRefereeModule::Status referee;
 		};
 		
 		static void createConfiguration(Configuration *cfg);
 
-		Processor(bool sim);
+		/**
+		 * If @lockstep is set (simulation only), soccer runs on simulated time:
+		 * each frame waits for a vision packet and the clock jumps to its capture time.
+		 */
+		Processor(bool sim, bool lockstep = false);
 		virtual ~Processor();
 		
 		void stop();
@@ -121,6 +183,23 @@ class Processor: public QThread
 			return _externalReferee;
 		}
 		
+		/**
+		 * If set, each frame starts when a vision frame arrives instead of on a fixed period.
+		 * Packets from all cameras that arrive close together are handled in one frame, and frames
+		 * are never closer together than most of a frame period.
+		 * If vision doesn't arrive within one frame period, the frame runs anyway.
+		 * Must be set before the processor is started.  Ignored in lockstep mode.
+		 */
+		void visionTriggered(bool value)
+		{
+			_visionTriggered = value;
+		}
+		
+		bool visionTriggered() const
+		{
+			return _visionTriggered;
+		}
+		
 		void manualID(int value);
 		int manualID()
 		{
@@ -168,6 +247,11 @@ class Processor: public QThread
 			return _simulation;
 		}
 
+		bool lockstep() const
+		{
+			return _lockstep;
+		}
+
 		void defendPlusX(bool value);
 		
 		Status status()
@@ -181,6 +265,16 @@ class Processor: public QThread
 			return _framerate;
 		}
 		
+		/**
+		 * Returns the state published at the end of the most recent frame.
+		 * This never waits for the processing loop, but it must only be called from one thread
+		 * (the GUI thread).
+		 */
+		const Snapshot &snapshot()
+		{
+			return _snapshot.read();
+		}
+		
 		const Logger &logger() const
 		{
 			return _logger;
@@ -238,7 +332,12 @@ class Processor: public QThread
 		/** send out the radio data for the radio program */
 		void sendRadioData();
 
-		void runModels(const std::vector<const SSL_DetectionFrame *> &detectionFrames);
+		/// Updates the ball and robot models from vision.
+		/// @captureTimes has the local capture time of each detection frame.
+		void runModels(const std::vector<const SSL_DetectionFrame *> &detectionFrames, const std::vector<uint64_t> &captureTimes);
+		
+		/// Returns true if vision at world x coordinate @x (in mm) is on a half of the field we aren't using
+		bool excludedByHalf(float x) const;
 		
 		/** Used to start and stop the thread **/
 		volatile bool _running;
@@ -253,6 +352,14 @@ class Processor: public QThread
 		// This changes network communications.
 		bool _simulation;
 		
+		// True if frames are driven by simulated vision instead of the wall clock.
+		bool _lockstep;
+		
+		bool _visionTriggered;
+
+		// Time source installed for timestamp() when running in lockstep
+		SimulatedClock _clock;
+		
 		// True if we are blue.
 		// False if we are yellow.
 		bool _blueTeam;
@@ -289,6 +396,11 @@ class Processor: public QThread
 		// This is used by the GUI to indicate status of the processing loop and network
 		QMutex _statusMutex;
 		Status _status;
+		
+		TripleBuffer<Snapshot> _snapshot;
+		
+		/// The frames published in Snapshot::history, newest first
+		std::deque<std::shared_ptr<Packet::LogFrame> > _recentFrames;
 
 		//modules
 		std::shared_ptr<NewRefereeModule> _refereeModule;
@@ -418,7 +418,9 @@ void ProtobufTree::contextMenuEvent(QContextMenuEvent* e)
 		if (field)
 		{
 			int t = field->type();
-			if (t == FieldDescriptor::TYPE_FLOAT || t == FieldDescriptor::TYPE_DOUBLE || (t == FieldDescriptor::TYPE_MESSAGE && field->message_type()->name() == "Point"))
+			if (t == FieldDescriptor::TYPE_FLOAT || t == FieldDescriptor::TYPE_DOUBLE ||
+				t == FieldDescriptor::TYPE_INT32 || t == FieldDescriptor::TYPE_SINT32 || t == FieldDescriptor::TYPE_UINT32 ||
+				(t == FieldDescriptor::TYPE_MESSAGE && field->message_type()->name() == "Point"))
 			{
 				chartAction = menu.addAction("Chart");
 			}
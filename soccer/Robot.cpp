@@ -84,6 +84,20 @@ OurRobot::OurRobot(int shell, SystemState *state):
 	_planner = new Planning::RRTPlanner();
 	_planner->maxIterations(250);
 
+	for (size_t i = 0; i < Num_Shells; ++i) {
+		_selfObstacleCircles[i] = std::make_shared<Circle>();
+		_oppObstacleCircles[i] = std::make_shared<Circle>();
+	}
+	_ballObstacleCircle = std::make_shared<Circle>();
+
+	_planned = false;
+	_selfObstaclesLayer = -1;
+	_oppObstaclesLayer = -1;
+	_ballObstaclesLayer = -1;
+	_plannedFrames = 0;
+	_reusedFrames = 0;
+	_straightFrames = 0;
+
 	resetAvoidRobotRadii();
 
 	_clearCmdText();
@@ -164,16 +178,43 @@ void OurRobot::addStatusText()
 	}
 }
 
-void OurRobot::addText(const QString& text, const QColor& qc, const QString &layerPrefix)
+void OurRobot::addText(const QString& text, const QColor& qc, const std::string &layerPrefix)
+{
+	if (_state->competitionMode())
+	{
+		return;
+	}
+
+	addText(text, qc, textLayer(layerPrefix));
+}
+
+void OurRobot::addText(const QString& text, const QColor& qc, int layer)
 {
+	if (!_state->debugLayerEnabled(layer))
+	{
+		return;
+	}
+
 	Packet::DebugText *dbg = new Packet::DebugText;
-	QString layer = layerPrefix + QString::number(shell());
-	dbg->set_layer(_state->findDebugLayer(layer));
+	dbg->set_layer(layer);
 	dbg->set_text(text.toStdString());
 	dbg->set_color(color(qc));
 	robotText.push_back(dbg);
 }
 
+int OurRobot::textLayer(const std::string &layerPrefix)
+{
+	std::map<std::string, int>::const_iterator i = _textLayers.find(layerPrefix);
+	if (i != _textLayers.end())
+	{
+		return i->second;
+	}
+
+	int layer = _state->findDebugLayer(QString::fromStdString(layerPrefix) + QString::number(shell()));
+	_textLayers[layerPrefix] = layer;
+	return layer;
+}
+
 bool OurRobot::avoidOpponents() const {
 	// checks for avoiding all opponents
 	for (size_t i=0; i<Num_Shells; ++i)
@@ -501,16 +542,20 @@ void OurRobot::resetAvoidBall() {
 	avoidBallRadius(Ball_Avoid_Small);
 }
 
-std::shared_ptr<Geometry2d::Shape> OurRobot::createBallObstacle() const {
+std::shared_ptr<Geometry2d::Shape> OurRobot::createBallObstacle() {
+	_ballObstacleCircle->center = _state->ball.pos;
+
 	// if game is stopped, large obstacle regardless of flags
 	if (_state->gameState.state != GameState::Playing && !(_state->gameState.ourRestart || _state->gameState.theirPenalty()))
 	{
-		return std::shared_ptr<Geometry2d::Shape>(new Circle(_state->ball.pos, Field_CenterRadius));
+		_ballObstacleCircle->radius(Field_CenterRadius);
+		return _ballObstacleCircle;
 	}
 
 	// create an obstacle if necessary
 	if (_avoidBallRadius > 0.0) {
-		return std::shared_ptr<Geometry2d::Shape>(new Circle(_state->ball.pos, _avoidBallRadius));
+		_ballObstacleCircle->radius(_avoidBallRadius);
+		return _ballObstacleCircle;
 	} else {
 		return std::shared_ptr<Geometry2d::Shape>();
 	}
@@ -555,6 +600,17 @@ int OurRobot::consecutivePathChangeCount() const {
 }
 
 void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles) {
+	planPath(global_obstacles);
+	drawPlanning();
+}
+
+void OurRobot::planPath(const Geometry2d::CompositeShape& global_obstacles) {
+	_planned = false;
+	_planningText.clear();
+	_selfObstacles.clear();
+	_oppObstacles.clear();
+	_ballObstacle.reset();
+
 	if (!_motionConstraints.targetPos) {
 		_path = boost::none;
 		return;
@@ -567,29 +623,29 @@ void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles
 		return;
 	}
 
-	// create and visualize obstacles
-	Geometry2d::CompositeShape full_obstacles(_local_obstacles);
-	Geometry2d::CompositeShape
-		self_obs = createRobotObstacles(_state->self, _self_avoid_mask),
-		opp_obs = createRobotObstacles(_state->opp, _opp_avoid_mask);
-	_state->drawCompositeShape(self_obs, Qt::gray, QString("self_obstacles_%1").arg(shell()));
-	_state->drawCompositeShape(opp_obs, Qt::gray, QString("opp_obstacles_%1").arg(shell()));
+	// create obstacles, they get drawn later by drawPlanning()
+	// The static field obstacles go first so they are checked first.
+	// None of this allocates once the storage has grown to fit.
+	_planned = true;
+	Geometry2d::CompositeShape &full_obstacles = _fullObstacles;
+	full_obstacles.clear();
+	full_obstacles.add(global_obstacles);
+	addRobotObstacles(_state->self, _self_avoid_mask, _selfObstacleCircles, _selfObstacles);
+	addRobotObstacles(_state->opp, _opp_avoid_mask, _oppObstacleCircles, _oppObstacles);
 	if (_state->ball.valid)
 	{
-		std::shared_ptr<Geometry2d::Shape> ball_obs = createBallObstacle();
-		_state->drawShape(ball_obs, Qt::gray, QString("ball_obstacles_%1").arg(shell()));
-		full_obstacles.add(ball_obs);
+		_ballObstacle = createBallObstacle();
+		full_obstacles.add(_ballObstacle);
 	}
-	full_obstacles.add(self_obs);
-	full_obstacles.add(opp_obs);
-	full_obstacles.add(global_obstacles);
+	full_obstacles.add(_selfObstacles);
+	full_obstacles.add(_oppObstacles);
+	full_obstacles.add(_local_obstacles);
 
 	// if no goal command robot to stop in place
 	if (!_motionConstraints.targetPos) {
 		if (verbose) cout << "in OurRobot::replanIfNeeded() for robot [" << shell() << "]: stopped" << std::endl;
-		addText(QString("replan: no goal"));
+		_planningText.push_back("replan: no goal");
 		setPath(Planning::Path(pos));
-		_state->drawPath(*_path);
 		return;
 	}
 
@@ -606,15 +662,12 @@ void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles
 		_pathInvalidated = true;
 	}
 
+	//	Validate the current path before doing any planning.  The RRT only runs if the
+	//	path turns out to be unusable, since that's by far the most expensive part of this.
 
-	Planning::Path newlyPlannedPath;
-	_planner->run(pos, angle, vel, *_motionConstraints.targetPos, &full_obstacles, newlyPlannedPath);
-
-	//	invalidate path if it hits obstacles
+	//	a blocked path is only replaced if the new one is clear, see below
 	//	TODO: it would be better to compare WHICH obstacles the old and new paths hit rather than just looking at IF they hit obstacles
-	if (_path && _path->hit(full_obstacles) && !newlyPlannedPath.hit(full_obstacles)) {
-		_pathInvalidated = true;
-	}
+	bool pathBlocked = _path && _path->hit(full_obstacles);
 
 	//  invalidate path if current position is more than 15cm from the planned point
 	if (_path) {
@@ -643,10 +696,11 @@ void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles
 		//	try a straight line path first
 		Geometry2d::Segment straight_seg(pos, *_motionConstraints.targetPos);
 		if (!full_obstacles.hit(straight_seg)) {
-			addText(QString("planner: pre-emptive straight_line"));
+			_planningText.push_back("planner: pre-emptive straight_line");
 			Planning::Path straightLine(pos, *_motionConstraints.targetPos);
 			setPath(straightLine);
 			_pathInvalidated = false;
+			pathBlocked = false;
 		}
 	}
 
@@ -654,8 +708,9 @@ void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles
 
 
 	// check if goal is close to previous goal to reuse path
-	if (!_pathInvalidated) {
-		addText("Reusing path");
+	if (!_pathInvalidated && !pathBlocked) {
+		_planningText.push_back("Reusing path");
+		++_reusedFrames;
 		// for (auto itr : _path->points) {
 		// 	cout << "\t(" << itr.x << ", " << itr.y << ")" << endl;
 		// }
@@ -666,12 +721,22 @@ void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles
 		//	try a straight line path first
 		Geometry2d::Segment straight_seg(pos, *_motionConstraints.targetPos);
 		if (!full_obstacles.hit(straight_seg)) {
-			addText(QString("planner: straight_line"));
+			_planningText.push_back("planner: straight_line");
 			Planning::Path straightLine(pos, *_motionConstraints.targetPos);
 			setPath(straightLine);
+			++_straightFrames;
 		} else {
 			//	rrt-planned path
-			setPath(newlyPlannedPath);
+			Planning::Path newlyPlannedPath;
+			_planner->run(pos, angle, vel, *_motionConstraints.targetPos, &full_obstacles, newlyPlannedPath);
+			++_plannedFrames;
+
+			//	if the old path was otherwise fine and the new one is blocked too, keep the old one
+			if (!_pathInvalidated && newlyPlannedPath.hit(full_obstacles)) {
+				_planningText.push_back("Reusing path");
+			} else {
+				setPath(newlyPlannedPath);
+			}
 		}
 	}
 
@@ -680,13 +745,38 @@ void OurRobot::replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles
 	_path->endSpeed = _motionConstraints.endSpeed;
 	_path->maxAcceleration = _motionConstraints.maxAcceleration;
 
-	_state->drawPath(*_path, Qt::magenta);
-
 	_pathChangeHistory.push_back(_didSetPathThisIteration);
 
 	return;
 }
 
+void OurRobot::drawPlanning() {
+	if (!_planned || _state->competitionMode()) {
+		return;
+	}
+
+	if (_selfObstaclesLayer < 0) {
+		// Only build the layer names once
+		_selfObstaclesLayer = _state->findDebugLayer(QString("self_obstacles_%1").arg(shell()));
+		_oppObstaclesLayer = _state->findDebugLayer(QString("opp_obstacles_%1").arg(shell()));
+		_ballObstaclesLayer = _state->findDebugLayer(QString("ball_obstacles_%1").arg(shell()));
+	}
+
+	_state->drawCompositeShape(_selfObstacles, Qt::gray, _selfObstaclesLayer);
+	_state->drawCompositeShape(_oppObstacles, Qt::gray, _oppObstaclesLayer);
+	if (_ballObstacle) {
+		_state->drawShape(_ballObstacle, Qt::gray, _ballObstaclesLayer);
+	}
+
+	BOOST_FOREACH(const QString &text, _planningText) {
+		addText(text);
+	}
+
+	if (_path) {
+		_state->drawPath(*_path, Qt::magenta);
+	}
+}
+
 bool OurRobot::charged() const
 {
 	return _radioRx.has_kicker_status() && (_radioRx.kicker_status() & 0x01) && rxIsFresh();
@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 #include <vector>
+#include <map>
+#include <string>
 #include <boost/optional.hpp>
 #include <boost/array.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
@@ -11,6 +13,7 @@
 #include <Constants.hpp>
 #include "MotionConstraints.hpp"
 #include <Utils.hpp>
+#include <Geometry2d/Circle.hpp>
 #include <planning/Path.hpp>
 #include <planning/RRTPlanner.hpp>
 #include <protobuf/RadioTx.pb.h>
@@ -140,7 +143,12 @@ public:
 
 	void addStatusText();
 	
-	void addText(const QString &text, const QColor &color = Qt::white, const QString &layerPrefix = "RobotText");
+	void addText(const QString &text, const QColor &color = Qt::white, const std::string &layerPrefix = "RobotText");
+	void addText(const QString &text, const QColor &color, int layer);
+
+	/// Returns the debug layer for this robot's text with the given prefix (e.g. "RobotText3").
+	/// The ID is looked up once per prefix so text drawn every frame doesn't build the layer name.
+	int textLayer(const std::string &layerPrefix);
 
 	// kicker readiness checks
 	bool charged() const; /// true if the kicker is ready
@@ -343,9 +351,38 @@ public:
 	/**
 	 * Replans the path if needed.
 	 * Sets some parameters on the path.
+	 * This is just planPath() followed by drawPlanning().
 	 */
 	void replanIfNeeded(const Geometry2d::CompositeShape& global_obstacles);
 
+	/**
+	 * The planning half of replanIfNeeded().
+	 * This only changes this robot's own state and reads the rest of the SystemState,
+	 * so it may be run for several robots at once.  Debug output is saved for drawPlanning().
+	 */
+	void planPath(const Geometry2d::CompositeShape& global_obstacles);
+
+	/**
+	 * Draws the obstacles, path, and planner messages from the last call to planPath().
+	 * This adds to the shared LogFrame so it must only be called from one thread at a time.
+	 */
+	void drawPlanning();
+
+	/// Number of frames in which planPath() had to run the RRT planner
+	uint32_t plannedFrames() const {
+		return _plannedFrames;
+	}
+
+	/// Number of frames in which planPath() kept the current path
+	uint32_t reusedFrames() const {
+		return _reusedFrames;
+	}
+
+	/// Number of frames in which planPath() replaced an invalid path with a straight line
+	uint32_t straightFrames() const {
+		return _straightFrames;
+	}
+
 
 	/** status evaluations for choosing robots in behaviors - combines multiple checks */
 	bool chipper_available() const;
@@ -419,29 +456,58 @@ protected:
 	///	whenever the constraints for the robot path are changed, this is set to true to trigger a replan
 	bool _pathInvalidated;
 
+	///	debug output from the last planPath() call, drawn later by drawPlanning()
+	bool _planned;
+	Geometry2d::CompositeShape _selfObstacles, _oppObstacles;
+	std::shared_ptr<Geometry2d::Shape> _ballObstacle;
+	std::vector<QString> _planningText;
+
+	///	debug layer IDs for drawPlanning(), looked up the first time they are needed
+	int _selfObstaclesLayer, _oppObstaclesLayer, _ballObstaclesLayer;
+
+	///	debug layer IDs for addText(), by prefix
+	std::map<std::string, int> _textLayers;
+
+	///	counters for how often the RRT planner was actually needed
+	uint32_t _plannedFrames;
+	uint32_t _reusedFrames;
+	uint32_t _straightFrames;
+
 
 	/**
-	 * Creates a set of obstacles from a given robot team mask,
+	 * Adds obstacles for a given robot team mask to @result,
 	 * where mask values < 0 create no obstacle, and larger values
 	 * create an obstacle of a given radius
 	 *
 	 * NOTE: mask must not be set for this robot
 	 *
 	 * @param robots is the set of robots to use to create a mask - either self or opp from _state
+	 * @param circles holds one obstacle per shell which is moved to the robot's position,
+	 *		so no new shapes are allocated each frame
 	 */
 	template<class ROBOT>
-	Geometry2d::CompositeShape createRobotObstacles(const std::vector<ROBOT*>& robots, const RobotMask& mask) const {
-		Geometry2d::CompositeShape result;
+	void addRobotObstacles(const std::vector<ROBOT*>& robots, const RobotMask& mask,
+			const std::shared_ptr<Geometry2d::Circle> *circles, Geometry2d::CompositeShape &result) const {
 		for (size_t i=0; i<RobotMask::size(); ++i)
-			if (mask[i] > 0 && robots[i] && robots[i]->visible)
-				result.add(std::shared_ptr<Geometry2d::Shape>(new Geometry2d::Circle(robots[i]->pos, mask[i])));
-		return result;
+			if (mask[i] > 0 && robots[i] && robots[i]->visible) {
+				circles[i]->center = robots[i]->pos;
+				circles[i]->radius(mask[i]);
+				result.add(circles[i]);
+			}
 	}
 
 	/**
 	 * Creates an obstacle for the ball if necessary
 	 */
-	std::shared_ptr<Geometry2d::Shape> createBallObstacle() const;
+	std::shared_ptr<Geometry2d::Shape> createBallObstacle();
+
+	///	reusable obstacle shapes for planPath()
+	std::shared_ptr<Geometry2d::Circle> _selfObstacleCircles[Num_Shells];
+	std::shared_ptr<Geometry2d::Circle> _oppObstacleCircles[Num_Shells];
+	std::shared_ptr<Geometry2d::Circle> _ballObstacleCircle;
+
+	///	all obstacles used for planning.  The storage is reused every frame.
+	Geometry2d::CompositeShape _fullObstacles;
 
 protected:
 	friend class Processor;
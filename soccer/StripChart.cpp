@@ -195,6 +195,15 @@ bool Chart::NumericField::value(const Packet::LogFrame& frame, float& v) const
 							v = ref->GetRepeatedDouble(*msg, fd, j);
 							break;
 						
+						case FieldDescriptor::TYPE_INT32:
+						case FieldDescriptor::TYPE_SINT32:
+							v = ref->GetRepeatedInt32(*msg, fd, j);
+							break;
+						
+						case FieldDescriptor::TYPE_UINT32:
+							v = ref->GetRepeatedUInt32(*msg, fd, j);
+							break;
+						
 						default:
 							fprintf(stderr, "NumericField: unsupported repeated field type %d\n", fd->type());
 							return false;
@@ -210,6 +219,15 @@ bool Chart::NumericField::value(const Packet::LogFrame& frame, float& v) const
 							v = ref->GetDouble(*msg, fd);
 							break;
 						
+						case FieldDescriptor::TYPE_INT32:
+						case FieldDescriptor::TYPE_SINT32:
+							v = ref->GetInt32(*msg, fd);
+							break;
+						
+						case FieldDescriptor::TYPE_UINT32:
+							v = ref->GetUInt32(*msg, fd);
+							break;
+						
 						default:
 							fprintf(stderr, "NumericField: unsupported field type %d\n", fd->type());
 							return false;
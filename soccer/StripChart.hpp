@@ -38,7 +38,7 @@ namespace Chart
 	{
 		virtual bool value(const Packet::LogFrame &frame, float &v) const;
 		
-		// Vector of tags from LogFrame to the float or double field to be used.
+		// Vector of tags from LogFrame to the float, double, or 32-bit integer field to be used.
 		// Each tag except the last one must identify a Message.
 		// A repeated field's tag is followed by the index of the item.
 		QVector<int> path;
@@ -12,6 +12,11 @@ SystemState::SystemState()
 {
 	timestamp = 0;
 	_numDebugLayers = 0;
+	_competitionMode = false;
+	for (int i = 0; i < MaxDebugLayers; ++i)
+	{
+		_debugLayerEnabled[i] = true;
+	}
 	
 	//FIXME - boost::array?
 	self.resize(Num_Shells);
@@ -32,20 +37,19 @@ SystemState::~SystemState()
 	}
 }
 
-int SystemState::findDebugLayer(QString layer)
+int SystemState::findDebugLayer(const QString &layer)
 {
-	if (layer.isNull())
-	{
-		layer = "Debug";
-	}
+	// Layer for drawing that doesn't name one.  This is static so it isn't built for every call.
+	static const QString DefaultLayer("Debug");
+	const QString &name = layer.isNull() ? DefaultLayer : layer;
 	
-	QMap<QString, int>::const_iterator i = _debugLayerMap.find(layer);
+	QMap<QString, int>::const_iterator i = _debugLayerMap.find(name);
 	if (i == _debugLayerMap.end())
 	{
 		// New layer
 		int n = _numDebugLayers++;
-		_debugLayerMap[layer] = n;
-		_debugLayers.append(layer);
+		_debugLayerMap[name] = n;
+		_debugLayers.append(name);
 		return n;
 	} else {
 		// Existing layer
@@ -53,10 +57,36 @@ int SystemState::findDebugLayer(QString layer)
 	}
 }
 
+int SystemState::findDebugLayer(const std::string &layer)
+{
+	std::map<std::string, int>::const_iterator i = _debugLayerIDs.find(layer);
+	if (i != _debugLayerIDs.end())
+	{
+		return i->second;
+	}
+	
+	int n = findDebugLayer(QString::fromStdString(layer));
+	_debugLayerIDs[layer] = n;
+	return n;
+}
+
 void SystemState::drawPath(const Planning::Path &path, const QColor& qc, const QString& layer)
 {
+	if (!_competitionMode)
+	{
+		drawPath(path, qc, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawPath(const Planning::Path &path, const QColor& qc, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	DebugPath *dbg = logFrame->add_debug_paths();
-	dbg->set_layer(findDebugLayer(layer));
+	dbg->set_layer(layer);
 	for (Geometry2d::Point pt : path.points)
 	{
 		*dbg->add_points() = pt;
@@ -66,8 +96,21 @@ void SystemState::drawPath(const Planning::Path &path, const QColor& qc, const Q
 
 void SystemState::drawPolygon(const Geometry2d::Point* pts, int n, const QColor& qc, const QString &layer)
 {
+	if (!_competitionMode)
+	{
+		drawPolygon(pts, n, qc, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawPolygon(const Geometry2d::Point* pts, int n, const QColor& qc, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	DebugPath *dbg = logFrame->add_debug_polygons();
-	dbg->set_layer(findDebugLayer(layer));
+	dbg->set_layer(layer);
 	for (int i = 0; i < n; ++i)
 	{
 		*dbg->add_points() = pts[i];
@@ -77,25 +120,54 @@ void SystemState::drawPolygon(const Geometry2d::Point* pts, int n, const QColor&
 
 void SystemState::drawPolygon(const std::vector<Geometry2d::Point>& pts, const QColor &qc, const QString &layer)
 {
-	DebugPath *dbg = logFrame->add_debug_polygons();
-	dbg->set_layer(findDebugLayer(layer));
-	for (size_t i = 0; i < pts.size(); ++i)
+	if (!_competitionMode)
 	{
-		*dbg->add_points() = pts[i];
+		drawPolygon(pts, qc, findDebugLayer(layer));
 	}
-	dbg->set_color(color(qc));
+}
+
+void SystemState::drawPolygon(const std::vector<Geometry2d::Point>& pts, const QColor &qc, int layer)
+{
+	drawPolygon(pts.empty() ? 0 : &pts[0], pts.size(), qc, layer);
 }
 
 void SystemState::drawCircle(const Geometry2d::Point& center, float radius, const QColor& qc, const QString &layer)
 {
+	if (!_competitionMode)
+	{
+		drawCircle(center, radius, qc, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawCircle(const Geometry2d::Point& center, float radius, const QColor& qc, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	DebugCircle *dbg = logFrame->add_debug_circles();
-	dbg->set_layer(findDebugLayer(layer));
+	dbg->set_layer(layer);
 	*dbg->mutable_center() = center;
 	dbg->set_radius(radius);
 	dbg->set_color(color(qc));
 }
 
-void SystemState::drawShape(const std::shared_ptr<Geometry2d::Shape>& obs, const QColor &color, const QString &layer) {
+void SystemState::drawShape(const std::shared_ptr<Geometry2d::Shape>& obs, const QColor &color, const QString &layer)
+{
+	if (!_competitionMode)
+	{
+		drawShape(obs, color, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawShape(const std::shared_ptr<Geometry2d::Shape>& obs, const QColor &color, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	std::shared_ptr<Geometry2d::Circle> circObs = std::dynamic_pointer_cast<Geometry2d::Circle>(obs);
 	std::shared_ptr<Geometry2d::Polygon> polyObs = std::dynamic_pointer_cast<Geometry2d::Polygon>(obs);
 	if (circObs)
@@ -106,28 +178,76 @@ void SystemState::drawShape(const std::shared_ptr<Geometry2d::Shape>& obs, const
 
 void SystemState::drawCompositeShape(const Geometry2d::CompositeShape& group, const QColor &color, const QString &layer)
 {
+	// Look up the layer once for the whole group
+	if (!_competitionMode)
+	{
+		drawCompositeShape(group, color, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawCompositeShape(const Geometry2d::CompositeShape& group, const QColor &color, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	BOOST_FOREACH(const std::shared_ptr<Geometry2d::Shape>& obs, group)
 		drawShape(obs, color, layer);
 }
 
 void SystemState::drawLine(const Geometry2d::Line& line, const QColor& qc, const QString &layer)
 {
+	if (!_competitionMode)
+	{
+		drawLine(line, qc, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawLine(const Geometry2d::Line& line, const QColor& qc, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	DebugPath *dbg = logFrame->add_debug_paths();
-	dbg->set_layer(findDebugLayer(layer));
+	dbg->set_layer(layer);
 	*dbg->add_points() = line.pt[0];
 	*dbg->add_points() = line.pt[1];
 	dbg->set_color(color(qc));
 }
 
 void SystemState::drawLine(const Geometry2d::Point &p0, const Geometry2d::Point &p1, const QColor &color, const QString &layer)
+{
+	if (!_competitionMode)
+	{
+		drawLine(Geometry2d::Line(p0, p1), color, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawLine(const Geometry2d::Point &p0, const Geometry2d::Point &p1, const QColor &color, int layer)
 {
 	drawLine(Geometry2d::Line(p0, p1), color, layer);
 }
 
 void SystemState::drawText(const QString& text, const Geometry2d::Point& pos, const QColor& qc, const QString &layer)
 {
+	if (!_competitionMode)
+	{
+		drawText(text, pos, qc, findDebugLayer(layer));
+	}
+}
+
+void SystemState::drawText(const QString& text, const Geometry2d::Point& pos, const QColor& qc, int layer)
+{
+	if (!debugLayerEnabled(layer))
+	{
+		return;
+	}
+	
 	DebugText *dbg = logFrame->add_debug_texts();
-	dbg->set_layer(findDebugLayer(layer));
+	dbg->set_layer(layer);
 	dbg->set_text(text.toStdString());
 	*dbg->mutable_pos() = pos;
 	dbg->set_color(color(qc));
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <vector>
+#include <map>
 #include <string>
 #include <memory>
+#include <atomic>
 
 #include <QMap>
 #include <QColor>
@@ -12,6 +14,7 @@
 #include <protobuf/RadioRx.pb.h>
 #include <GameState.hpp>
 #include <planning/Path.hpp>
+#include <modeling/BallTrajectory.hpp>
 #include <Constants.hpp>
 
 class RobotConfig;
@@ -30,14 +33,25 @@ public:
 	{
 		valid = false;
 		time = 0;
+		slidingSpeed = 0;
 	}
 	
 	Geometry2d::Point pos;
 	Geometry2d::Point vel;
 	bool valid;
 	
+	/// If the ball was kicked recently, it slides until it slows to this speed.
+	/// Zero if the ball is rolling.
+	float slidingSpeed;
+	
 	/// Time at which this estimate is valid
 	uint64_t time;
+	
+	/// Predicted path of the ball from this estimate, if nothing touches it
+	BallTrajectory trajectory() const
+	{
+		return BallTrajectory(pos, vel, slidingSpeed);
+	}
 };
 
 /**
@@ -63,26 +77,83 @@ public:
 	 * Each drawing function also associates the drawn content with a particular
 	 * 'layer'.  Separating drawing items into layers lets you choose at runtime
 	 * which items actually get drawn.
+	 *
+	 * A layer may be given by name or by the ID returned by findDebugLayer().
+	 * Code that draws every frame should look up the ID once and use that.
+	 * Nothing is added for a layer that is turned off with debugLayerEnabled() or in
+	 * competition mode, and these are checked before anything is allocated.
 	 */
 
 	/** @ingroup drawing_functions */
 	void drawLine(const Geometry2d::Line &line, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawLine(const Geometry2d::Line &line, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawLine(const Geometry2d::Point &p0, const Geometry2d::Point &p1, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawLine(const Geometry2d::Point &p0, const Geometry2d::Point &p1, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawCircle(const Geometry2d::Point &center, float radius, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawCircle(const Geometry2d::Point &center, float radius, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawPath(const Planning::Path& path, const QColor &color = Qt::black, const QString &layer = "Motion");
 	/** @ingroup drawing_functions */
+	void drawPath(const Planning::Path& path, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawPolygon(const Geometry2d::Point *pts, int n, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawPolygon(const Geometry2d::Point *pts, int n, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawPolygon(const std::vector<Geometry2d::Point>& pts, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawPolygon(const std::vector<Geometry2d::Point>& pts, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawText(const QString &text, const Geometry2d::Point &pos, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawText(const QString &text, const Geometry2d::Point &pos, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawShape(const std::shared_ptr<Geometry2d::Shape>& obs, const QColor &color = Qt::black, const QString &layer = QString());
 	/** @ingroup drawing_functions */
+	void drawShape(const std::shared_ptr<Geometry2d::Shape>& obs, const QColor &color, int layer);
+	/** @ingroup drawing_functions */
 	void drawCompositeShape(const Geometry2d::CompositeShape& group, const QColor &color = Qt::black, const QString &layer = QString());
+	/** @ingroup drawing_functions */
+	void drawCompositeShape(const Geometry2d::CompositeShape& group, const QColor &color, int layer);
+	
+	/// Number of debug layers that can be turned off.  Layers with higher IDs are always drawn.
+	static const int MaxDebugLayers = 256;
+	
+	/// Returns true if things drawn on @layer are kept
+	bool debugLayerEnabled(int layer) const
+	{
+		if (_competitionMode.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+		return layer < 0 || layer >= MaxDebugLayers || _debugLayerEnabled[layer].load(std::memory_order_relaxed);
+	}
+	
+	/// Turns drawing on a layer on or off.  This may be called from any thread (e.g. when the GUI
+	/// hides a layer).  Nothing is logged for a layer while it is off.
+	void debugLayerEnabled(int layer, bool value)
+	{
+		if (layer >= 0 && layer < MaxDebugLayers)
+		{
+			_debugLayerEnabled[layer].store(value, std::memory_order_relaxed);
+		}
+	}
+	
+	/// In competition mode all debug drawing is skipped
+	bool competitionMode() const
+	{
+		return _competitionMode.load(std::memory_order_relaxed);
+	}
+	
+	void competitionMode(bool value)
+	{
+		_competitionMode.store(value, std::memory_order_relaxed);
+	}
 	
 	uint64_t timestamp;
 	GameState gameState;
@@ -106,17 +177,29 @@ public:
 		return _debugLayers;
 	}
 
-	/// Returns the number of a debug layer given its name
-	int findDebugLayer(QString layer);
+	/// Returns the number of a debug layer given its name, adding the layer if it is new
+	int findDebugLayer(const QString &layer);
+	
+	/// Same as above for callers that have a std::string (e.g. Python).
+	/// Names that have been seen before are found without building a QString.
+	int findDebugLayer(const std::string &layer);
 	
 private:
 	
 	/// Map from debug layer name to ID
 	QMap<QString, int> _debugLayerMap;
 	
+	/// Cache of findDebugLayer(const std::string &)
+	std::map<std::string, int> _debugLayerIDs;
+	
 	/// Debug layers in order by ID
 	QStringList _debugLayers;
 	
 	/// Number of debug layers
 	int _numDebugLayers;
+	
+	/// Which layers are drawn, indexed by ID
+	std::atomic<bool> _debugLayerEnabled[MaxDebugLayers];
+	
+	std::atomic<bool> _competitionMode;
 };
@@ -6,14 +6,29 @@
 #include <QMutexLocker>
 #include <QUdpSocket>
 #include <stdexcept>
+#include <algorithm>
 
 using namespace std;
 
+// Number of packets in the pool.
+// The processor normally holds a few packets per frame, so this allows for it to fall well behind.
+static const int PoolSize = 32;
+
 VisionReceiver::VisionReceiver(bool sim, int port)
 {
 	simulation = sim;
 	_running = false;
 	this->port = port;
+	_droppedPackets = 0;
+	
+	_pool.reserve(PoolSize);
+	_freePackets.reserve(PoolSize);
+	_packets.reserve(PoolSize);
+	for (int i = 0; i < PoolSize; ++i)
+	{
+		_pool.push_back(unique_ptr<VisionPacket>(new VisionPacket));
+		_freePackets.push_back(_pool.back().get());
+	}
 }
 
 void VisionReceiver::stop()
@@ -30,6 +45,45 @@ void VisionReceiver::getPackets(std::vector<VisionPacket *>& packets)
 	_mutex.unlock();
 }
 
+void VisionReceiver::releasePackets(std::vector<VisionPacket *> &packets)
+{
+	QMutexLocker locker(&_mutex);
+	_freePackets.insert(_freePackets.end(), packets.begin(), packets.end());
+	packets.clear();
+}
+
+VisionPacket *VisionReceiver::allocPacket()
+{
+	QMutexLocker locker(&_mutex);
+	if (_freePackets.empty())
+	{
+		if (_packets.empty())
+		{
+			return 0;
+		}
+		
+		// Nobody is reading packets, so drop the oldest
+		VisionPacket *packet = _packets.front();
+		_packets.erase(_packets.begin());
+		++_droppedPackets;
+		return packet;
+	}
+	
+	VisionPacket *packet = _freePackets.back();
+	_freePackets.pop_back();
+	return packet;
+}
+
+bool VisionReceiver::waitForPackets(unsigned long timeout_ms)
+{
+	QMutexLocker locker(&_mutex);
+	if (_packets.empty())
+	{
+		_packetsAvailable.wait(&_mutex, timeout_ms);
+	}
+	return !_packets.empty();
+}
+
 void VisionReceiver::run()
 {
 	QUdpSocket socket;
@@ -56,15 +110,9 @@ void VisionReceiver::run()
 		multicast_add(&socket, SharedVisionAddress);
 	}
 	
-	// There should be at most four packets: one for each camera on each of two frames, assuming some clock skew between this
-	// computer and the vision computer.
-	_packets.reserve(4);
-	
 	_running = true;
 	while (_running)
 	{
-		char buf[65536];
-		
 		// Wait for a UDP packet
 		if (!socket.waitForReadyRead(500))
 		{
@@ -72,31 +120,46 @@ void VisionReceiver::run()
 			continue;
 		}
 		
+		VisionPacket *packet = allocPacket();
+		if (!packet)
+		{
+			// The processor is holding every packet.  Leave the datagram in the socket for now.
+			::usleep(1000);
+			continue;
+		}
+		
+		// Read directly into the packet's buffer, which keeps its capacity between uses
 		QHostAddress host;
 		quint16 portNumber = 0;
-		qint64 size = socket.readDatagram(buf, sizeof(buf), &host, &portNumber);
+		packet->data.resize(max<qint64>(socket.pendingDatagramSize(), 1));
+		qint64 size = socket.readDatagram(&packet->data[0], packet->data.size(), &host, &portNumber);
 		if (size < 1)
 		{
 			fprintf(stderr, "VisionReceiver: %s\n", (const char *)socket.errorString().toAscii());
+			vector<VisionPacket *> unused(1, packet);
+			releasePackets(unused);
 			// See Processor for why we can't use QThread::msleep()
 			::usleep(100 * 1000);
 			continue;
 		}
+		packet->data.resize(size);
 		
 		//FIXME - Verify that it is from the right host, in case there are multiple visions on the network
 		
 		// Parse the protobuf message
-		VisionPacket *packet = new VisionPacket;
 		packet->receivedTime = timestamp();
-		if (!packet->wrapper.ParseFromArray(buf, size))
+		if (!packet->wrapper.ParseFromString(packet->data))
 		{
 			fprintf(stderr, "VisionReceiver: got bad packet of %d bytes from %s:%d\n", (int)size, (const char *)host.toString().toAscii(), portNumber);
+			vector<VisionPacket *> unused(1, packet);
+			releasePackets(unused);
 			continue;
 		}
 		
 		// Add to the vector of packets
 		_mutex.lock();
 		_packets.push_back(packet);
+		_packetsAvailable.wakeAll();
 		_mutex.unlock();
 	}
 }
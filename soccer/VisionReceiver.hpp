@@ -4,8 +4,12 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
 
 #include <vector>
+#include <string>
+#include <memory>
 
 #include <stdint.h>
 #include <Network.hpp>
@@ -18,7 +22,12 @@ public:
 	/// Local time when the packet was received
 	uint64_t receivedTime;
 	
-	/// protobuf message from the vision system
+	/// Datagram as received.  Its buffer is reused when the packet is recycled.
+	std::string data;
+	
+	/// protobuf message from the vision system, parsed from data.
+	/// The processor may swap this into its LogFrame instead of copying it.  That leaves this
+	/// message empty, so the next parse allocates its submessages again.
 	SSL_WrapperPacket wrapper;
 };
 /**
@@ -35,8 +44,22 @@ public:
 	/// The vector contains only packets received since the last time this was called
 	/// (or since the VisionReceiver was started, if getPackets has never been called).
 	///
-	/// The caller is responsible for freeing the packets after this function returns.
+	/// Packets come from a fixed pool.  The caller must give them back with releasePackets().
 	void getPackets(std::vector<VisionPacket *> &packets);
+	
+	/// Returns packets from getPackets() to the pool and clears @packets
+	void releasePackets(std::vector<VisionPacket *> &packets);
+	
+	/// Number of received packets that were discarded because the pool was empty
+	int droppedPackets()
+	{
+		QMutexLocker locker(&_mutex);
+		return _droppedPackets;
+	}
+
+	/// Blocks until at least one packet is available or @timeout_ms passes.
+	/// Returns true if packets are available.
+	bool waitForPackets(unsigned long timeout_ms);
 
 	bool simulation;
 	int port;
@@ -46,7 +69,23 @@ protected:
 	
 	volatile bool _running;
 	
-	/// This mutex protects the vector of packets
+	/// Takes a packet from the pool.
+	/// If the pool is empty, the oldest packet that hasn't been taken by getPackets() is reused.
+	/// Returns null if every packet is held by the caller of getPackets().
+	VisionPacket *allocPacket();
+	
+	/// This mutex protects the vector of packets and the pool
 	QMutex _mutex;
 	std::vector<VisionPacket *> _packets;
+	
+	/// Owns every packet
+	std::vector<std::unique_ptr<VisionPacket> > _pool;
+	
+	/// Packets that are neither waiting in _packets nor held by the caller of getPackets()
+	std::vector<VisionPacket *> _freePackets;
+	
+	int _droppedPackets;
+
+	/// Signalled when a packet is added to _packets
+	QWaitCondition _packetsAvailable;
 };
@@ -4,11 +4,14 @@
 #include <protobuf/LogFrame.pb.h>
 #include <Robot.hpp>
 #include <SystemState.hpp>
+#include <Utils.hpp>
 
 #include <stdio.h>
 #include <iostream>
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
+#include <exception>
+#include <QRunnable>
 
 //	for python stuff
 #include "robocup-py.hpp"
@@ -20,6 +23,35 @@ using namespace boost::python;
 using namespace Geometry2d;
 
 
+namespace
+{
+	/// Plans the path for one robot on a thread in the planning pool
+	class PlanPathTask: public QRunnable
+	{
+	public:
+		PlanPathTask(OurRobot *robot, const Geometry2d::CompositeShape *obstacles):
+			robot(robot),
+			obstacles(obstacles)
+		{
+			setAutoDelete(false);
+		}
+
+		void run()
+		{
+			//	exceptions can't cross threads, so save it and rethrow it from the gameplay thread
+			try {
+				robot->planPath(*obstacles);
+			} catch (...) {
+				error = std::current_exception();
+			}
+		}
+
+		OurRobot *robot;
+		const Geometry2d::CompositeShape *obstacles;
+		std::exception_ptr error;
+	};
+}
+
 
 Gameplay::GameplayModule::GameplayModule(SystemState *state):
 	_mutex(QMutex::Recursive)
@@ -101,6 +133,42 @@ Gameplay::GameplayModule::GameplayModule(SystemState *state):
 	_opponentHalf->vertices.push_back(Geometry2d::Point(x, y2));
 	_opponentHalf->vertices.push_back(Geometry2d::Point(x, y1));
 
+	//	build the static obstacles for every combination of rules
+	for (int stayOnSide = 0; stayOnSide < 2; ++stayOnSide)
+	{
+		for (int useOurHalf = 0; useOurHalf < 2; ++useOurHalf)
+		{
+			for (int useOpponentHalf = 0; useOpponentHalf < 2; ++useOpponentHalf)
+			{
+				CompositeShape &obstacles = _staticObstacles[staticObstaclesIndex(stayOnSide, useOurHalf, useOpponentHalf)];
+				if (stayOnSide)
+				{
+					obstacles.add(_sideObstacle);
+				}
+
+				if (!useOurHalf)
+				{
+					obstacles.add(_ourHalf);
+				}
+
+				if (!useOpponentHalf)
+				{
+					obstacles.add(_opponentHalf);
+				}
+
+				/// Add non floor obstacles
+				BOOST_FOREACH(const std::shared_ptr<Shape>& ptr, _nonFloor)
+				{
+					obstacles.add(ptr);
+				}
+
+				CompositeShape &withGoal = _staticObstaclesWithGoal[staticObstaclesIndex(stayOnSide, useOurHalf, useOpponentHalf)];
+				withGoal.add(obstacles);
+				withGoal.add(_goalArea);
+			}
+		}
+	}
+
 	_goalieID = -1;
 
 
@@ -180,32 +248,20 @@ void Gameplay::GameplayModule::goalieID(int value)
 	} PyGILState_Release(state);
 }
 
+int Gameplay::GameplayModule::staticObstaclesIndex(bool stayOnSide, bool useOurHalf, bool useOpponentHalf) {
+	return (stayOnSide ? 4 : 0) | (useOurHalf ? 2 : 0) | (useOpponentHalf ? 1 : 0);
+}
+
 /**
  * returns the group of obstacles for the field
  */
-Geometry2d::CompositeShape Gameplay::GameplayModule::globalObstacles() const {
-	Geometry2d::CompositeShape obstacles;
-	if (_state->gameState.stayOnSide())
-	{
-		obstacles.add(_sideObstacle);
-	}
-
-	if (!_state->logFrame->use_our_half())
-	{
-		obstacles.add(_ourHalf);
-	}
-
-	if (!_state->logFrame->use_opponent_half())
-	{
-		obstacles.add(_opponentHalf);
-	}
+const Geometry2d::CompositeShape &Gameplay::GameplayModule::globalObstacles(bool withGoalArea) const {
+	int i = staticObstaclesIndex(
+		_state->gameState.stayOnSide(),
+		_state->logFrame->use_our_half(),
+		_state->logFrame->use_opponent_half());
 
-	/// Add non floor obstacles
-	BOOST_FOREACH(const std::shared_ptr<Shape>& ptr, _nonFloor)
-	{
-		obstacles.add(ptr);
-	}
-	return obstacles;
+	return withGoalArea ? _staticObstaclesWithGoal[i] : _staticObstacles[i];
 }
 
 /**
@@ -241,37 +297,41 @@ void Gameplay::GameplayModule::run()
 		}
 	}
 
+	uint64_t pythonStart = ScopedTimer::now();
 	PyGILState_STATE state = PyGILState_Ensure(); {
 		try {
-			//	vector of shared pointers to pass to python
-			std::vector<OurRobot *> *botVector = new std::vector<OurRobot *>();
-			for (auto itr = _playRobots.begin(); itr != _playRobots.end(); itr++) {
-				OurRobot *ourBot = *itr;
-				//	don't attempt to drive the robot that's joystick-controlled
-				//	FIXME: exclude manual id robot
-				// if (ourBot->shell() != MANUAL_ID) {
-					botVector->push_back(ourBot);
-				// }
+			//	FIXME: exclude manual id robot so we don't attempt to drive the one that's joystick-controlled
+			_world.ourRobots.assign(_playRobots.begin(), _playRobots.end());
+			_world.ourPos.clear();
+			_world.ourVel.clear();
+			BOOST_FOREACH(OurRobot *r, _world.ourRobots)
+			{
+				_world.ourPos.push_back(r->pos);
+				_world.ourVel.push_back(r->vel);
 			}
-			getMainModule().attr("set_our_robots")(botVector);
 
-			std::vector<OpponentRobot *> *theirBotVector = new std::vector<OpponentRobot *>();
-			for (auto itr = _state->opp.begin(); itr != _state->opp.end(); itr++) {
-				OpponentRobot *bot = *itr;
-				if (bot && bot->visible) {
-					theirBotVector->push_back(bot);
+			_world.theirRobots.clear();
+			_world.theirPos.clear();
+			_world.theirVel.clear();
+			BOOST_FOREACH(OpponentRobot *r, _state->opp)
+			{
+				if (r && r->visible)
+				{
+					_world.theirRobots.push_back(r);
+					_world.theirPos.push_back(r->pos);
+					_world.theirVel.push_back(r->vel);
 				}
 			}
-			getMainModule().attr("set_their_robots")(theirBotVector);
-
-			getMainModule().attr("set_game_state")(_state->gameState);
 
-			getMainModule().attr("set_system_state")(&_state);
+			_world.ball = _state->ball;
+			_world.gameState = _state->gameState;
+			_world.state = _state;
 
-			getMainModule().attr("set_ball")(_state->ball);
+			//	one call into python for the whole frame
+			getMainModule().attr("set_world")(boost::python::ptr(&_world));
 		} catch (error_already_set) {
 			PyErr_Print();
-			throw new runtime_error("Error trying to pass robots and/or ball and/or game state to python");
+			throw new runtime_error("Error trying to pass the world snapshot to python");
 		}
 
 		/// Run the current play
@@ -304,23 +364,41 @@ void Gameplay::GameplayModule::run()
 	        throw new runtime_error("Error trying to run root play");
 	    }
 	} PyGILState_Release(state);
+	_state->logFrame->mutable_timing()->set_gameplay_python(ScopedTimer::now() - pythonStart);
+
+	uint64_t planningStart = ScopedTimer::now();
 
 	/// determine global obstacles - field requirements
 	/// Two versions - one set with goal area, another without for goalie
-	Geometry2d::CompositeShape global_obstacles = globalObstacles();
-	Geometry2d::CompositeShape obstacles_with_goal = global_obstacles;
-	obstacles_with_goal.add(_goalArea);
+	const Geometry2d::CompositeShape &global_obstacles = globalObstacles(false);
+	const Geometry2d::CompositeShape &obstacles_with_goal = globalObstacles(true);
 
 	/// execute motion planning for each robot
+	/// Each robot has its own planner, so they all plan at the same time on the planning pool.
+	/// Drawing goes into the shared LogFrame, so that's done afterwards on this thread.
+	boost::ptr_vector<PlanPathTask> planTasks;
 	BOOST_FOREACH(OurRobot* r, _state->self) {
 		if (r && r->visible) {
 			/// set obstacles for the robots
 			if (r->shell() == _goalieID)
-				r->replanIfNeeded(global_obstacles); /// just for goalie
+				planTasks.push_back(new PlanPathTask(r, &global_obstacles)); /// just for goalie
 			else
-				r->replanIfNeeded(obstacles_with_goal); /// all other robots
+				planTasks.push_back(new PlanPathTask(r, &obstacles_with_goal)); /// all other robots
+		}
+	}
+
+	BOOST_FOREACH(PlanPathTask &task, planTasks) {
+		_planningPool.start(&task);
+	}
+	_planningPool.waitForDone();
+
+	BOOST_FOREACH(PlanPathTask &task, planTasks) {
+		if (task.error) {
+			std::rethrow_exception(task.error);
 		}
+		task.robot->drawPlanning();
 	}
+	_state->logFrame->mutable_timing()->set_gameplay_planning(ScopedTimer::now() - planningStart);
 
 	/// visualize
 	if (_state->gameState.stayAwayFromBall() && _state->ball.valid)
@@ -9,10 +9,12 @@
 #include <Geometry2d/Polygon.hpp>
 #include <Geometry2d/Point.hpp>
 #include <Geometry2d/CompositeShape.hpp>
+#include <gameplay/WorldSnapshot.hpp>
 
 #include <set>
 #include <QMutex>
 #include <QString>
+#include <QThreadPool>
 
 #include <boost/ptr_container/ptr_vector.hpp>
 
@@ -136,12 +138,27 @@ namespace Gameplay
 			///	goal area
 			Geometry2d::CompositeShape _goalArea;
 
+			///	Field obstacles for every combination of the rules that change them.
+			///	These are built once in the constructor and never change, so each frame
+			///	just picks one by reference instead of building a new set of obstacles.
+			///	Indexed by staticObstaclesIndex().
+			static const int NumStaticObstacleSets = 8;
+			Geometry2d::CompositeShape _staticObstacles[NumStaticObstacleSets];
+			Geometry2d::CompositeShape _staticObstaclesWithGoal[NumStaticObstacleSets];
+
+			///	threads used to plan paths for all robots at the same time
+			QThreadPool _planningPool;
+
 			/// utility functions
 
 			/**
 			 * Returns the current set of global obstacles, including the field
+			 * @param withGoalArea if true, our goal area is included too (for everyone but the goalie)
 			 */
-			Geometry2d::CompositeShape globalObstacles() const;
+			const Geometry2d::CompositeShape &globalObstacles(bool withGoalArea) const;
+
+			///	index into _staticObstacles for the given rules
+			static int staticObstaclesIndex(bool stayOnSide, bool useOurHalf, bool useOpponentHalf);
 
 			int _our_score_last_frame;
 
@@ -151,5 +168,8 @@ namespace Gameplay
 
 			//	python
 			boost::python::object _mainPyNamespace;
+
+			///	handed to python once per frame.  Reused so the robot lists aren't reallocated every frame.
+			WorldSnapshot _world;
 	};
 }
@@ -0,0 +1,224 @@
+#include "RoleAssignment.hpp"
+
+#include <Constants.hpp>
+
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+using namespace Geometry2d;
+
+// Large enough to dominate any sum of soft costs, but finite so potentials stay meaningful
+const double Gameplay::RoleAssignment::MaxWeight = 10000000;
+const double Gameplay::RoleAssignment::PositionCostMultiplier = 1.0;
+const double Gameplay::RoleAssignment::RobotChangeCost = 1.0;
+
+Gameplay::RoleAssignment::RoleAssignment()
+{
+	_shellPotential.assign(Num_Shells, 0);
+}
+
+void Gameplay::RoleAssignment::reset()
+{
+	_shellPotential.assign(Num_Shells, 0);
+}
+
+double Gameplay::RoleAssignment::cost(const RoleCandidate &candidate, const RoleRequirement &req)
+{
+	if (req.requiredShell >= 0 && req.requiredShell != candidate.shell)
+	{
+		return MaxWeight;
+	}
+
+	if (req.hasBall && !candidate.hasBall)
+	{
+		return MaxWeight;
+	}
+
+	if (req.requireKicking && !candidate.canKick)
+	{
+		return MaxWeight;
+	}
+
+	double cost = 0;
+	if (req.hasDestination)
+	{
+		cost += PositionCostMultiplier * req.destination.distTo(candidate.pos);
+	}
+
+	if (req.previousShell >= 0 && req.previousShell != candidate.shell)
+	{
+		cost += RobotChangeCost;
+	}
+
+	if (!candidate.hasChipper)
+	{
+		cost += req.chipperPreference;
+	}
+
+	return cost;
+}
+
+bool Gameplay::RoleAssignment::assign(const vector<RoleCandidate> &candidates, const vector<RoleRequirement> &reqs,
+	vector<int> &assignment)
+{
+	int rows = reqs.size();
+	int cols = candidates.size();
+	if (rows > cols)
+	{
+		assignment.clear();
+		return false;
+	}
+
+	_costs.resize(rows * cols);
+	vector<int> colIds(cols);
+	for (int j = 0; j < cols; ++j)
+	{
+		colIds[j] = candidates[j].shell;
+	}
+
+	for (int i = 0; i < rows; ++i)
+	{
+		for (int j = 0; j < cols; ++j)
+		{
+			_costs[i * cols + j] = cost(candidates[j], reqs[i]);
+		}
+	}
+
+	solve(_costs, rows, cols, colIds, assignment);
+
+	bool ok = true;
+	for (int i = 0; i < rows; ++i)
+	{
+		if (_costs[i * cols + assignment[i]] >= MaxWeight)
+		{
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+double Gameplay::RoleAssignment::solve(const vector<double> &costs, int rows, int cols, const vector<int> &colIds,
+	vector<int> &assignment)
+{
+	const double Inf = numeric_limits<double>::infinity();
+
+	assignment.assign(rows, -1);
+	if (rows == 0)
+	{
+		return 0;
+	}
+
+	// Rows past @rows are dummies with zero cost, so the problem is square.
+	// Then every column is assigned and its potential may take any value,
+	// which is what lets the previous solve's potentials be reused.
+	int n = cols;
+
+	_u.assign(n + 1, 0);
+	_v.assign(cols + 1, 0);
+	_p.assign(cols + 1, 0);
+	_way.assign(cols + 1, 0);
+	_minv.resize(cols + 1);
+	_used.resize(cols + 1);
+
+	// Start from the column potentials of the last solve.
+	// Choosing each row potential as its smallest reduced cost makes the starting duals feasible.
+	for (int j = 1; j <= cols; ++j)
+	{
+		int id = colIds[j - 1];
+		if (id >= 0 && id < (int)_shellPotential.size())
+		{
+			_v[j] = _shellPotential[id];
+		}
+	}
+	for (int i = 1; i <= n; ++i)
+	{
+		double m = Inf;
+		for (int j = 1; j <= cols; ++j)
+		{
+			m = min(m, (i <= rows ? costs[(i - 1) * cols + j - 1] : 0) - _v[j]);
+		}
+		_u[i] = m;
+	}
+
+	// Add one row at a time, growing a shortest augmenting path from it
+	for (int i = 1; i <= n; ++i)
+	{
+		_p[0] = i;
+		int j0 = 0;
+		fill(_minv.begin(), _minv.end(), Inf);
+		fill(_used.begin(), _used.end(), false);
+
+		do
+		{
+			_used[j0] = true;
+			int i0 = _p[j0];
+			double delta = Inf;
+			int j1 = 0;
+			for (int j = 1; j <= cols; ++j)
+			{
+				if (!_used[j])
+				{
+					double cur = (i0 <= rows ? costs[(i0 - 1) * cols + j - 1] : 0) - _u[i0] - _v[j];
+					if (cur < _minv[j])
+					{
+						_minv[j] = cur;
+						_way[j] = j0;
+					}
+					if (_minv[j] < delta)
+					{
+						delta = _minv[j];
+						j1 = j;
+					}
+				}
+			}
+
+			for (int j = 0; j <= cols; ++j)
+			{
+				if (_used[j])
+				{
+					_u[_p[j]] += delta;
+					_v[j] -= delta;
+				} else {
+					_minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		} while (_p[j0] != 0);
+
+		// Flip the augmenting path
+		do
+		{
+			int j1 = _way[j0];
+			_p[j0] = _p[j1];
+			j0 = j1;
+		} while (j0);
+	}
+
+	// Potentials only go down during a solve.  Shifting them all by the same amount keeps them
+	// feasible, so save them relative to the largest to keep them from drifting across frames.
+	double maxV = -Inf;
+	for (int j = 1; j <= cols; ++j)
+	{
+		maxV = max(maxV, _v[j]);
+	}
+
+	double total = 0;
+	for (int j = 1; j <= cols; ++j)
+	{
+		if (_p[j] <= rows)
+		{
+			assignment[_p[j] - 1] = j - 1;
+			total += costs[(_p[j] - 1) * cols + j - 1];
+		}
+
+		int id = colIds[j - 1];
+		if (id >= 0 && id < (int)_shellPotential.size())
+		{
+			_shellPotential[id] = _v[j] - maxV;
+		}
+	}
+
+	return total;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Geometry2d/Point.hpp>
+#include <Geometry2d/Segment.hpp>
+
+#include <vector>
+
+namespace Gameplay
+{
+	/// What a role needs from the robot that fills it.
+	/// This mirrors role_assignment.RoleRequirements in Python.
+	struct RoleRequirement
+	{
+		RoleRequirement():
+			hasDestination(false), hasBall(false), requireKicking(false),
+			chipperPreference(0), requiredShell(-1), previousShell(-1)
+		{
+		}
+
+		/// If set, robots closer to @destination cost less.  A point is a zero-length segment.
+		bool hasDestination;
+		Geometry2d::Segment destination;
+
+		bool hasBall;
+
+		/// Requires a working kicker and ball sensor and a robot that may touch the ball
+		bool requireKicking;
+
+		/// Added to the cost of a robot without a chipper
+		float chipperPreference;
+
+		/// Shell that must fill this role, or -1 for any
+		int requiredShell;
+
+		/// Shell that filled this role last time, or -1.  Other robots cost a little more.
+		int previousShell;
+	};
+
+	/// The state of a robot that role assignment cares about
+	struct RoleCandidate
+	{
+		RoleCandidate(): shell(-1), hasBall(false), canKick(false), hasChipper(false) {}
+
+		int shell;
+		Geometry2d::Point pos;
+		bool hasBall;
+
+		/// Kicker and ball sensor work and the double touch rule doesn't forbid touching the ball
+		bool canKick;
+
+		bool hasChipper;
+	};
+
+	/**
+	 * Assigns robots to roles with the Hungarian algorithm in O(n^3).
+	 *
+	 * An instance should be kept across frames: the dual potential of each robot is saved
+	 * after a solve and used to start the next one, so when little has changed the augmenting
+	 * paths are short.  Scratch space is reused so a solve does not allocate once it has
+	 * seen the largest problem.
+	 */
+	class RoleAssignment
+	{
+		public:
+			/// Cost of a robot that doesn't meet a hard requirement of a role
+			static const double MaxWeight;
+
+			/// Multiply this by the distance between a robot and a destination to get the cost
+			static const double PositionCostMultiplier;
+
+			/// Penalty for switching robots in the middle of a play
+			static const double RobotChangeCost;
+
+			RoleAssignment();
+
+			/// Cost of @candidate filling @req
+			static double cost(const RoleCandidate &candidate, const RoleRequirement &req);
+
+			/// Chooses a different candidate for each requirement with the smallest total cost.
+			/// There must be at least as many candidates as requirements.
+			/// @assignment[i] is the index in @candidates of the robot for reqs[i].
+			/// Returns false if some requirement can't be met.
+			bool assign(const std::vector<RoleCandidate> &candidates, const std::vector<RoleRequirement> &reqs,
+				std::vector<int> &assignment);
+
+			/// Solves the rectangular assignment problem for a row-major @rows x @cols cost matrix
+			/// with rows <= cols.  Extra columns are left unassigned.
+			/// @colIds identifies each column across calls for warm starting and must be
+			/// in [0, Num_Shells) or -1 for a column with no saved potential.
+			/// @assignment[r] is the column assigned to row r.  Returns the total cost.
+			double solve(const std::vector<double> &costs, int rows, int cols, const std::vector<int> &colIds,
+				std::vector<int> &assignment);
+
+			/// Forgets the potentials from previous solves
+			void reset();
+
+		private:
+			/// Potential of each shell's column from the last solve
+			std::vector<double> _shellPotential;
+
+			// Scratch space, indexed from 1 with 0 as the unassigned row or the virtual column
+			std::vector<double> _costs;
+			std::vector<double> _u;
+			std::vector<double> _v;
+			std::vector<double> _minv;
+			std::vector<int> _p;
+			std::vector<int> _way;
+			std::vector<bool> _used;
+	};
+}
@@ -0,0 +1,163 @@
+#include "WindowEvaluator.hpp"
+
+#include <Constants.hpp>
+
+#include <math.h>
+#include <algorithm>
+
+using namespace std;
+using namespace Geometry2d;
+
+Gameplay::WindowEvaluator::WindowEvaluator()
+{
+	chipEnabled = false;
+	minChipRange = 0.3;
+	maxChipRange = 4.0;
+}
+
+void Gameplay::WindowEvaluator::obstacleRange(vector<Window> &windows, float t0, float t1)
+{
+	if (t0 == t1)
+	{
+		// Ignore degenerate obstacles
+		return;
+	}
+
+	if (t0 > t1)
+	{
+		swap(t0, t1);
+	}
+
+	for (unsigned int i = 0; i < windows.size();)
+	{
+		Window &w = windows[i];
+		if (t0 <= w.t0 && t1 >= w.t1)
+		{
+			// This window is fully covered by the obstacle, so remove it
+			windows.erase(windows.begin() + i);
+		} else if (t0 > w.t0 && t1 < w.t1)
+		{
+			// The window fully contains the obstacle, so split the window
+			Window w2(t1, w.t1);
+			w.t1 = t0;
+			windows.insert(windows.begin() + i + 1, w2);
+			i += 2;
+		} else if (t0 > w.t0 && t0 < w.t1)
+		{
+			// The obstacle covers the end of the window
+			w.t1 = t0;
+			++i;
+		} else if (t1 > w.t0 && t1 < w.t1)
+		{
+			// The obstacle covers the beginning of the window
+			w.t0 = t1;
+			++i;
+		} else {
+			++i;
+		}
+	}
+}
+
+void Gameplay::WindowEvaluator::obstacleRobot(vector<Window> &windows, Point origin, const Segment &target, float end, Point pos)
+{
+	Point n = (pos - origin).normalized();
+	Point t = n.perpCCW();
+	const float r = Robot_Radius + Ball_Radius;
+	Point edgeEnd[2] =
+	{
+		pos - n * Robot_Radius + t * r,
+		pos - n * Robot_Radius - t * r
+	};
+
+	Point p0 = target.pt[0];
+	Point delta = target.delta();
+
+	float extent[2] = {0, end};
+	for (int i = 0; i < 2; ++i)
+	{
+		// Intersect the line from the origin past this edge of the robot with the target line:
+		// origin + u * e = p0 + s * delta
+		Point e = edgeEnd[i] - origin;
+		float denom = e.cross(delta);
+		if (denom == 0)
+		{
+			// Obstacle has no effect
+			return;
+		}
+
+		float u = (p0 - origin).cross(delta) / denom;
+		if (u <= 1)
+		{
+			// The target is not behind the robot
+			return;
+		}
+
+		float s = (p0 - origin).cross(e) / denom;
+		extent[i] = max(0.0f, min(end, s * end));
+	}
+
+	obstacleRange(windows, extent[0], extent[1]);
+}
+
+int Gameplay::WindowEvaluator::evaluate(Point origin, const Segment &target, vector<Window> &windows) const
+{
+	windows.clear();
+
+	float end = target.delta().magsq();
+	if (end == 0)
+	{
+		// A degenerate target can't have any windows
+		return -1;
+	}
+
+	windows.push_back(Window(0, end));
+
+	for (unsigned int i = 0; i < obstacles.size() && !windows.empty(); ++i)
+	{
+		float d = obstacles[i].distTo(origin);
+		bool chipOverable = chipEnabled &&
+			d < maxChipRange - Robot_Radius &&
+			d > minChipRange + Robot_Radius;
+		if (!chipOverable)
+		{
+			obstacleRobot(windows, origin, target, end, obstacles[i]);
+		}
+	}
+
+	// Set the segment and angles for each window and find the largest
+	Point p0 = target.pt[0];
+	Point delta = target.delta() / end;
+	int best = -1;
+	for (unsigned int i = 0; i < windows.size(); ++i)
+	{
+		Window &w = windows[i];
+		w.segment = Segment(p0 + delta * w.t0, p0 + delta * w.t1);
+		w.a0 = (w.segment.pt[0] - origin).angle() * 180 / M_PI;
+		w.a1 = (w.segment.pt[1] - origin).angle() * 180 / M_PI;
+
+		if (best < 0 || w.segment.delta().magsq() > windows[best].segment.delta().magsq())
+		{
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+void Gameplay::WindowEvaluator::evaluateBest(const vector<Point> &origins, const Segment &target,
+	vector<Window> &best, vector<bool> &found) const
+{
+	best.resize(origins.size());
+	found.resize(origins.size());
+
+	// Reused for every origin
+	vector<Window> windows;
+	windows.reserve(obstacles.size() + 1);
+
+	for (unsigned int i = 0; i < origins.size(); ++i)
+	{
+		int b = evaluate(origins[i], target, windows);
+		found[i] = b >= 0;
+		best[i] = found[i] ? windows[b] : Window();
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Geometry2d/Point.hpp>
+#include <Geometry2d/Segment.hpp>
+
+#include <vector>
+
+namespace Gameplay
+{
+	// A window is a triangle.  WindowEvaluator creates zero or more Windows.
+	// One vertex is the origin passed to evaluate().
+	// The side opposite this origin is a part of the original target segment.
+	struct Window
+	{
+		Window(float t0 = 0, float t1 = 0): t0(t0), t1(t1), a0(0), a1(0) {}
+
+		// Ends of the window along the target, as the dot product with the target's delta
+		// (0 at target.pt[0] and target.delta().magsq() at target.pt[1])
+		float t0, t1;
+
+		// Angles (in degrees) from origin along the edges of this window
+		float a0, a1;
+
+		// Piece of the target segment which represents this window
+		Geometry2d::Segment segment;
+	};
+
+	/**
+	 * Finds the parts of a target segment that can be reached in a straight line from an origin
+	 * without hitting any of a set of robots.
+	 *
+	 * Windows are kept as a flat list of intervals along the target, so evaluating many origins
+	 * against the same obstacles doesn't allocate per query.
+	 */
+	class WindowEvaluator
+	{
+		public:
+			WindowEvaluator();
+
+			// Positions of robots that block shots
+			std::vector<Geometry2d::Point> obstacles;
+
+			// If enabled, obstacles that are between minChipRange and maxChipRange from the origin
+			// can be chipped over and are ignored
+			bool chipEnabled;
+			float minChipRange;
+			float maxChipRange;
+
+			// Finds the open windows from @origin to @target.
+			// Returns the index in @windows of the largest window, or -1 if there are none.
+			int evaluate(Geometry2d::Point origin, const Geometry2d::Segment &target, std::vector<Window> &windows) const;
+
+			// Finds the largest window from each of @origins to @target.
+			// @found[i] is false if origins[i] has no open window.
+			void evaluateBest(const std::vector<Geometry2d::Point> &origins, const Geometry2d::Segment &target,
+				std::vector<Window> &best, std::vector<bool> &found) const;
+
+		private:
+			// Removes the interval [t0, t1] from @windows
+			static void obstacleRange(std::vector<Window> &windows, float t0, float t1);
+
+			// Removes the part of the target blocked by a robot at @pos
+			static void obstacleRobot(std::vector<Window> &windows, Geometry2d::Point origin, const Geometry2d::Segment &target,
+				float end, Geometry2d::Point pos);
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SystemState.hpp>
+
+#include <vector>
+
+namespace Gameplay
+{
+	/**
+	 * What gameplay in Python sees of the world for one frame.
+	 *
+	 * GameplayModule fills this once per frame and passes it to main.set_world() in one call
+	 * instead of calling a setter for each piece.  Python converts each part once per frame
+	 * and keeps the result, so plays don't cross into C++ every time they read a robot's position.
+	 *
+	 * The vectors keep their capacity between frames, so filling this doesn't allocate
+	 * once the most robots have been seen.
+	 */
+	struct WorldSnapshot
+	{
+		WorldSnapshot(): state(nullptr)
+		{
+		}
+
+		/// Our robots that plays may use
+		std::vector<OurRobot *> ourRobots;
+
+		/// Visible opponents
+		std::vector<OpponentRobot *> theirRobots;
+
+		/// Positions and velocities of ourRobots and theirRobots, in the same order
+		std::vector<Geometry2d::Point> ourPos, ourVel;
+		std::vector<Geometry2d::Point> theirPos, theirVel;
+
+		/// Copies so every play sees the same values for the whole frame
+		Ball ball;
+		GameState gameState;
+
+		SystemState *state;
+	};
+}
@@ -28,28 +28,18 @@ def is_in_our_goalie_zone():
         return False
 
 
-FrictionCoefficient = 0.04148
-GravitationalCoefficient = 9.81 # in m/s^2
+# The ball's motion is modeled in C++ by robocup.BallTrajectory, which includes rolling friction
+# and stops the ball instead of reversing it.
+# For many queries on the same ball, use main.ball().trajectory() and its batch methods
+# (positions(), times_to_reach(), intercepts()) instead of calling these in a loop.
 
-# The ball's motion follows the equation X(t) = X_i + V_i*t - 0.5*(c*g)*t^2
 def predict(X_i, V_i, t):
-    return X_i + (V_i * t) - (V_i.normalized() * 0.5 * FrictionCoefficient * GravitationalCoefficient * t**2)
+    return robocup.BallTrajectory(X_i, V_i).pos(t)
 
 
 def rev_predict(V_i, dist):
     """predict how much time it will take the ball to travel the given distance"""
-
-    # use the quadratic formula (a^2x + bx + c = 0 -> (-b +/- sqrt(b^2-4ac)) / 2a)
-    a = -0.5 * FrictionCoefficient * GravitationalCoefficient
-    b = V_i.mag()
-    c = -dist
-
-    # we ignore the second solution because it doesn't make sense in this context
-    b4ac = b**2 - 4 * a * c
-    if b4ac > 0:
-        return (-b + math.sqrt(b4ac)) / 2 * a
-    else:
-        return float("inf")
+    return robocup.BallTrajectory(robocup.Point(0, 0), V_i).time_to_reach(dist)
 
 
 # returns a Robot or None indicating which opponent has the ball
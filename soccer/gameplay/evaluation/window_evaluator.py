@@ -6,54 +6,12 @@ import main
 # A window is a triangle.  WindowEvaluator creates zero or more Windows.
 # One vertex is the origin passed to run().
 # The side opposite this origin is a part of the original target segment.
-class Window:
-
-    def __init__(self, t0, t1):
-        self.t0 = t0
-        self.t1 = t1
-
-
-    # a0 and a1 are the angles from the shot-point to @segment
-
-    @property
-    def a0(self):
-        return self._a0
-    @a0.setter
-    def a0(self, value):
-        self._a0 = value
-
-    @property
-    def a1(self):
-        return self._a1
-    @a1.setter
-    def a1(self, value):
-        self._a1 = value
-
-
-    @property
-    def t0(self):
-        return self._t0
-    @t0.setter
-    def t0(self, value):
-        self._t0 = value
-
-    @property
-    def t1(self):
-        return self._t1
-    @t1.setter
-    def t1(self, value):
-        self._t1 = value
-    
-
-    # the sub-segment of the original target segment that this window represents
-    @property
-    def segment(self):
-        return self._segment
-    @segment.setter
-    def segment(self, value):
-        self._segment = value
-    
-    
+#
+# Windows come from the C++ evaluator and have these attributes:
+#   t0, t1 - ends of the window as distances along the target segment
+#   a0, a1 - angles (in degrees) from the origin to the ends of the window
+#   segment - the sub-segment of the original target segment that this window represents
+Window = robocup.Window
 
 
 # The window evaluator finds triangles from the given origin point to the given target point/segment
@@ -78,6 +36,9 @@ class WindowEvaluator:
         self.excluded_robots = []
         self.hypothetical_robot_locations = []
 
+        self._native = None
+        self._native_key = None
+
 
     # Defaults to False
     # if True, uses the system state drawing methods to draw Windows
@@ -153,120 +114,65 @@ class WindowEvaluator:
         return self.eval_pt_to_seg(origin, constants.Field.OurGoalSegment)
 
 
-    # t0 and t1 are distances from segment.get_pt(0) along the segment
-    # we use these to remove windows and pieces of windows that are blocked
-    # modifies @windows in place
-    def obstacle_range(self, windows, t0, t1):
-        if t0 == t1:
-            # ignore degenerate obstacles
-            return
-
-        if t0 > t1:
-            t0, t1 = t1, t0
-
-
-        i = 0
-        while i != len(windows):
-            w = windows[i]
-
-            if t0 <= w.t0 and t1 >= w.t1:
-                # this window is fully covered by the obstacle, so remove it
-                del windows[i]
-            elif t0 > w.t0 and t1 < w.t1:
-                # the window fully contains the obstacle, so we split the window
-                w2 = Window(t1, w.t1)
-                w.t1 = t0
-                windows.insert(i+1, w2)
-                i += 2
-            elif t0 > w.t0 and t0 < w.t1:
-                # the obstacle covers the end of the window
-                w.t1 = t0
-                i += 1
-            elif t1 > w.t0 and t1 < w.t1:
-                # the obstacle covers the beginning of the window
-                w.t0 = t1
-                i += 1
-            else:
-                i += 1
-
-
-    def obstacle_robot(self, windows, origin, target, bot_pos):
-        n = (bot_pos - origin).normalized()
-        t = n.perp_ccw()
-        r = constants.Robot.Radius + constants.Ball.Radius
-        seg = robocup.Segment(bot_pos - n*constants.Robot.Radius + t * r,
-                                bot_pos - n*constants.Robot.Radius - t * r)
-
-        if self.debug:
-            main.system_state().draw_line(seg, constants.Colors.Red, "debug")
-
-        end = target.delta().magsq()
-        extent = [0, end]
-
-        for i in range(2):
-            edge = robocup.Line(origin, seg.get_pt(i))
-            d = edge.delta().magsq()
-
-            intersect = edge.line_intersection(target)
-            if intersect != None and (intersect - origin).dot(edge.delta()) > d:
-                t = (intersect - target.get_pt(0)).dot(target.delta())
-                if t < 0:
-                    extent[i] = 0
-                elif t > end:
-                    extent[i] = end
-                else:
-                    extent[i] = t
-            else:
-                # Obstacle has no effect
-                return
-        self.obstacle_range(windows, extent[0], extent[1])
-
-
-    def eval_pt_to_seg(self, origin, target):
-        end = target.delta().magsq()
-
-        # if target is a zero-length segment, there are no windows
-        if end == 0:
-            return [], None
-
-        if self.debug:
-            main.system_state().draw_line(target, constants.Colors.Blue, "Debug")
-
-        windows = [Window(0, end)]
-
-        # apply the obstacles
-        bots = filter(lambda bot: bot not in self.excluded_robots and bot.visible, (list(main.our_robots()) + list(main.their_robots())))
-        bot_locations = list(map(lambda bot: bot.pos, bots))
+    # positions of all robots that block windows
+    def obstacles(self):
+        bots = list(main.our_robots()) + list(main.their_robots())
+        positions = list(main.our_positions()) + list(main.their_positions())
+        bot_locations = [pos for bot, pos in zip(bots, positions) if bot not in self.excluded_robots and bot.visible]
         bot_locations.extend(self.hypothetical_robot_locations)
-        for pos in bot_locations:
+        return bot_locations
+
+
+    # The C++ evaluator that does the actual work, with this frame's obstacles.
+    # It's built the first time it's needed in a frame and reused until the robots or
+    # any of the settings above change.
+    def native_evaluator(self):
+        key = (main.world_version(), self.chip_enabled, self.min_chip_range, self.max_chip_range,
+                tuple(self.excluded_robots), tuple(self.hypothetical_robot_locations))
+        if self._native is None or self._native_key != key:
+            self._native = robocup.WindowEvaluator()
+            self._native.chip_enabled = self.chip_enabled
+            self._native.min_chip_range = self.min_chip_range
+            self._native.max_chip_range = self.max_chip_range
+            self._native.set_obstacles(self.obstacles())
+            self._native_key = key
+        return self._native
+
+
+    # draws the part of each obstacle that blocks shots from @origin
+    def draw_obstacles(self, origin):
+        r = constants.Robot.Radius + constants.Ball.Radius
+        for pos in self.obstacles():
             d = (pos - origin).mag()
             # whether or not we can chip over this bot
             chip_overable = (self.chip_enabled
                             and (d < self.max_chip_range - constants.Robot.Radius)
                             and (d > self.min_chip_range + constants.Robot.Radius))
-            if not chip_overable:
-                self.obstacle_robot(windows, origin, target, pos)
+            if chip_overable or d == 0:
+                continue
 
-        # set the segment and angles for each window
-        p0 = target.get_pt(0)
-        delta = target.delta() / end
+            n = (pos - origin).normalized()
+            t = n.perp_ccw()
+            seg = robocup.Segment(pos - n * constants.Robot.Radius + t * r,
+                                    pos - n * constants.Robot.Radius - t * r)
+            main.system_state().draw_line(seg, constants.Colors.Red, "Debug")
 
-        for w in windows:
-            w.segment = robocup.Segment(p0 + delta * w.t0, p0 + delta * w.t1)
-            w.a0 = (w.segment.get_pt(0) - origin).angle() * constants.RadiansToDegrees
-            w.a1 = (w.segment.get_pt(1) - origin).angle() * constants.RadiansToDegrees
 
-        best = max(windows, key=lambda w: w.segment.delta().magsq()) if len(windows) > 0 else None
+    def eval_pt_to_seg(self, origin, target):
+        if self.debug:
+            main.system_state().draw_line(target, constants.Colors.Blue, "Debug")
+            self.draw_obstacles(origin)
+
+        windows, best = self.native_evaluator().eval_pt_to_seg(origin, target)
 
         if self.debug and best is not None:
             main.system_state().draw_line(best.segment, constants.Colors.Green, "Debug")
             main.system_state().draw_line(robocup.Line(origin, best.segment.center()), constants.Colors.Green, "Debug")
 
-        # # draw the windows if we're in debug mode
-        # if self.debug:
-        #     for w in windows:
-        #         pts = [origin, w.segment.get_pt(0), w.segment.get_pt(1)]
-        #         color = (255, 0, 0) if w == best else (0, 255, 0)
-        #         main.system_state().draw_polygon(pts, 3, color, "Windows")
-
         return windows, best
+
+
+    # Evaluates many origins against one target in a single call.
+    # Returns a list with the best window (or None) for each origin.
+    def eval_pts_to_seg(self, origins, target):
+        return self.native_evaluator().eval_pts_to_seg(origins, target)
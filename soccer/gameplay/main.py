@@ -157,6 +157,52 @@ def our_robot_with_id(ID):
 # set by the C++ GameplayModule
 ############################################################
 
+# GameplayModule calls this once per frame with a robocup.WorldSnapshot.
+# Each part is converted once here so plays read plain python objects for the rest of the frame.
+_world = None
+def set_world(world):
+    global _world, _game_state, _ball, _our_robots, _their_robots, _system_state
+    global _our_positions, _their_positions, _world_version
+    _world = world
+    _world_version += 1
+    _game_state = world.game_state
+    _ball = world.ball
+    _our_robots = world.our_robots
+    _their_robots = world.their_robots
+    _system_state = world.system_state
+    _our_positions = None
+    _their_positions = None
+    root_play().robots = _our_robots
+
+# changes whenever the robots do, so things computed from them can be cached until then
+_world_version = 0
+def world_version():
+    return _world_version
+
+# positions of our_robots() and their_robots(), in the same order
+# these are only fetched from C++ the first time they're used in a frame
+_our_positions = None
+def our_positions():
+    global _our_positions
+    if _our_positions is None:
+        if _world is not None:
+            _our_positions = _world.our_positions()
+        else:
+            _our_positions = tuple(r.pos for r in _our_robots)
+    return _our_positions
+
+_their_positions = None
+def their_positions():
+    global _their_positions
+    if _their_positions is None:
+        if _world is not None:
+            _their_positions = _world.their_positions()
+        else:
+            _their_positions = tuple(r.pos for r in _their_robots)
+    return _their_positions
+
+# the setters below are for tests that build the world by hand
+
 _game_state = None
 def game_state():
     global _game_state
@@ -178,17 +224,23 @@ def our_robots():
     global _our_robots
     return _our_robots
 def set_our_robots(value):
-    global _our_robots
+    global _our_robots, _our_positions, _world, _world_version
     root_play().robots = value
     _our_robots = value
+    _our_positions = None
+    _world = None
+    _world_version += 1
 
 _their_robots = None
 def their_robots():
     global _their_robots
     return _their_robots
 def set_their_robots(value):
-    global _their_robots
+    global _their_robots, _their_positions, _world, _world_version
     _their_robots = value
+    _their_positions = None
+    _world = None
+    _world_version += 1
 
 _system_state = None
 def system_state():
@@ -14,6 +14,9 @@ using namespace boost::python;
 #include <Robot.hpp>
 #include <SystemState.hpp>
 #include <protobuf/LogFrame.pb.h>
+#include "WindowEvaluator.hpp"
+#include "RoleAssignment.hpp"
+#include "WorldSnapshot.hpp"
 
 #include <boost/python/exception_translator.hpp>
 #include <exception>
@@ -123,7 +126,12 @@ void OurRobot_approach_opponent(OurRobot *self, unsigned shell_id, bool enable_a
 }
 
 void OurRobot_add_text(OurRobot *self, const std::string &text, boost::python::tuple rgb, const std::string &layerPrefix) {
-	self->addText(QString::fromStdString(text), Color_from_tuple(rgb), QString::fromStdString(layerPrefix));
+	if (self->state()->competitionMode())
+		return;
+	int layer = self->textLayer(layerPrefix);
+	if (!self->state()->debugLayerEnabled(layer))
+		return;
+	self->addText(QString::fromStdString(text), Color_from_tuple(rgb), layer);
 }
 
 void OurRobot_set_avoid_opponents(OurRobot *self, bool value) {
@@ -212,28 +220,49 @@ boost::python::tuple Line_intersects_circle(Geometry2d::Line *self, Geometry2d::
 void State_draw_circle(SystemState *self, const Geometry2d::Point *center, float radius, boost::python::tuple rgb, const std::string &layer) {
 	if(center == nullptr)
 		throw NullArgumentException("center");
-	self->drawCircle(*center, radius, Color_from_tuple(rgb), QString::fromStdString(layer));
+	if (self->competitionMode())
+		return;
+	int id = self->findDebugLayer(layer);
+	if (!self->debugLayerEnabled(id))
+		return;
+	self->drawCircle(*center, radius, Color_from_tuple(rgb), id);
 }
 
 void State_draw_line(SystemState *self, const Geometry2d::Line *line, boost::python::tuple rgb, const std::string &layer) {
 	if(line == nullptr)
 		throw NullArgumentException("line");
-	self->drawLine(*line, Color_from_tuple(rgb), QString::fromStdString(layer));
+	if (self->competitionMode())
+		return;
+	int id = self->findDebugLayer(layer);
+	if (!self->debugLayerEnabled(id))
+		return;
+	self->drawLine(*line, Color_from_tuple(rgb), id);
 }
 
 void State_draw_text(SystemState *self, const std::string &text, Geometry2d::Point *pos, boost::python::tuple rgb, const std::string &layer) {
 	if(pos == nullptr)
 		throw NullArgumentException("pos");
-	self->drawText(QString::fromStdString(text), *pos, Color_from_tuple(rgb), QString::fromStdString(layer));
+	if (self->competitionMode())
+		return;
+	int id = self->findDebugLayer(layer);
+	if (!self->debugLayerEnabled(id))
+		return;
+	self->drawText(QString::fromStdString(text), *pos, Color_from_tuple(rgb), id);
 }
 
 void State_draw_polygon(SystemState *self, boost::python::list points, boost::python::tuple rgb, const std::string &layer) {
+	if (self->competitionMode())
+		return;
+	int id = self->findDebugLayer(layer);
+	if (!self->debugLayerEnabled(id))
+		return;
+
 	std::vector<Geometry2d::Point> ptVec;
 	for (int i = 0; i < len(points); i++) {
 		ptVec.push_back(boost::python::extract<Geometry2d::Point>(points[i]));
 	}
 
-	self->drawPolygon(ptVec, Color_from_tuple(rgb), QString::fromStdString(layer));
+	self->drawPolygon(ptVec, Color_from_tuple(rgb), id);
 }
 
 boost::python::list Circle_intersects_line(Geometry2d::Circle *self, const Geometry2d::Line *line) {
@@ -250,6 +279,214 @@ boost::python::list Circle_intersects_line(Geometry2d::Circle *self, const Geome
 	return lst;
 }
 
+BallTrajectory *BallTrajectory_init(const Geometry2d::Point &pos, const Geometry2d::Point &vel) {
+	return new BallTrajectory(pos, vel);
+}
+
+boost::python::list BallTrajectory_positions(BallTrajectory *self, boost::python::object times) {
+	std::vector<float> timeVec;
+	for (int i = 0; i < len(times); i++) {
+		timeVec.push_back(boost::python::extract<float>(times[i]));
+	}
+
+	std::vector<Geometry2d::Point> positions;
+	self->positions(timeVec, positions);
+
+	boost::python::list lst;
+	for (unsigned int i = 0; i < positions.size(); i++) {
+		lst.append(positions[i]);
+	}
+	return lst;
+}
+
+boost::python::list BallTrajectory_times_to_reach(BallTrajectory *self, boost::python::object dists) {
+	std::vector<float> distVec;
+	for (int i = 0; i < len(dists); i++) {
+		distVec.push_back(boost::python::extract<float>(dists[i]));
+	}
+
+	std::vector<float> times;
+	self->timesToReach(distVec, times);
+
+	boost::python::list lst;
+	for (unsigned int i = 0; i < times.size(); i++) {
+		lst.append(times[i]);
+	}
+	return lst;
+}
+
+/// Returns a (point, time) tuple for each robot giving where and when it can first get to the ball
+boost::python::list BallTrajectory_intercepts(BallTrajectory *self, boost::python::object robots) {
+	boost::python::list lst;
+	for (int i = 0; i < len(robots); i++) {
+		OurRobot *robot = boost::python::extract<OurRobot *>(robots[i]);
+		if (robot == nullptr)
+			throw NullArgumentException("robot");
+
+		const MotionConstraints &constraints = robot->motionConstraints();
+		Geometry2d::Point where;
+		float t = self->interceptTime(robot->pos, constraints.maxSpeed, constraints.maxAcceleration, &where);
+		lst.append(boost::python::make_tuple(where, t));
+	}
+	return lst;
+}
+
+/// Converts a vector from a WorldSnapshot to a python tuple of copies
+template<typename T>
+boost::python::tuple tuple_from_vector(const std::vector<T> &vec) {
+	boost::python::list lst;
+	for (const T &x : vec) {
+		lst.append(x);
+	}
+	return boost::python::tuple(lst);
+}
+
+/// Robots are passed by reference since python commands them through these objects
+template<typename T>
+boost::python::tuple tuple_from_vector(const std::vector<T *> &vec) {
+	boost::python::list lst;
+	for (T *x : vec) {
+		lst.append(boost::python::ptr(x));
+	}
+	return boost::python::tuple(lst);
+}
+
+boost::python::tuple WorldSnapshot_our_robots(Gameplay::WorldSnapshot *self) {
+	return tuple_from_vector(self->ourRobots);
+}
+
+boost::python::tuple WorldSnapshot_their_robots(Gameplay::WorldSnapshot *self) {
+	return tuple_from_vector(self->theirRobots);
+}
+
+boost::python::tuple WorldSnapshot_our_positions(Gameplay::WorldSnapshot *self) {
+	return tuple_from_vector(self->ourPos);
+}
+
+boost::python::tuple WorldSnapshot_our_velocities(Gameplay::WorldSnapshot *self) {
+	return tuple_from_vector(self->ourVel);
+}
+
+boost::python::tuple WorldSnapshot_their_positions(Gameplay::WorldSnapshot *self) {
+	return tuple_from_vector(self->theirPos);
+}
+
+boost::python::tuple WorldSnapshot_their_velocities(Gameplay::WorldSnapshot *self) {
+	return tuple_from_vector(self->theirVel);
+}
+
+Ball WorldSnapshot_ball(Gameplay::WorldSnapshot *self) {
+	return self->ball;
+}
+
+GameState WorldSnapshot_game_state(Gameplay::WorldSnapshot *self) {
+	return self->gameState;
+}
+
+SystemState *WorldSnapshot_system_state(Gameplay::WorldSnapshot *self) {
+	return self->state;
+}
+
+void WindowEvaluator_set_obstacles(Gameplay::WindowEvaluator *self, boost::python::object points) {
+	self->obstacles.clear();
+	for (int i = 0; i < len(points); i++) {
+		self->obstacles.push_back(boost::python::extract<Geometry2d::Point>(points[i]));
+	}
+}
+
+/// Returns a tuple (list of windows, best window or None)
+boost::python::tuple WindowEvaluator_eval_pt_to_seg(Gameplay::WindowEvaluator *self, const Geometry2d::Point &origin, const Geometry2d::Segment &target) {
+	std::vector<Gameplay::Window> windows;
+	int best = self->evaluate(origin, target, windows);
+
+	boost::python::list lst;
+	for (unsigned int i = 0; i < windows.size(); i++) {
+		lst.append(windows[i]);
+	}
+
+	// The best window is the same object as its entry in the list
+	boost::python::object bestWindow = best >= 0 ? boost::python::object(lst[best]) : boost::python::object();
+	return boost::python::make_tuple(lst, bestWindow);
+}
+
+/// Returns the best window (or None) from each of a list of origins
+boost::python::list WindowEvaluator_eval_pts_to_seg(Gameplay::WindowEvaluator *self, boost::python::object origins, const Geometry2d::Segment &target) {
+	std::vector<Geometry2d::Point> originVec;
+	for (int i = 0; i < len(origins); i++) {
+		originVec.push_back(boost::python::extract<Geometry2d::Point>(origins[i]));
+	}
+
+	std::vector<Gameplay::Window> best;
+	std::vector<bool> found;
+	self->evaluateBest(originVec, target, best, found);
+
+	boost::python::list lst;
+	for (unsigned int i = 0; i < best.size(); i++) {
+		lst.append(found[i] ? boost::python::object(best[i]) : boost::python::object());
+	}
+	return lst;
+}
+
+/// Returns the index in @robots of the robot for each of @reqs (role_assignment.RoleRequirements),
+/// or None if the requirements can't be met.
+/// @forbidden_shell is the robot that the double touch rule keeps from touching the ball, or None.
+boost::python::object RoleAssignment_assign(Gameplay::RoleAssignment *self, boost::python::object robots, boost::python::object reqs, boost::python::object forbidden_shell) {
+	int forbidden = forbidden_shell.ptr() == Py_None ? -1 : boost::python::extract<int>(forbidden_shell);
+
+	std::vector<Gameplay::RoleCandidate> candidates(len(robots));
+	for (unsigned int i = 0; i < candidates.size(); i++) {
+		OurRobot *robot = boost::python::extract<OurRobot *>(robots[i]);
+		if (robot == nullptr)
+			throw NullArgumentException("robot");
+
+		Gameplay::RoleCandidate &c = candidates[i];
+		c.shell = robot->shell();
+		c.pos = robot->pos;
+		c.hasBall = robot->hasBall();
+		c.canKick = c.shell != forbidden && robot->kickerWorks() && robot->ballSenseWorks();
+		c.hasChipper = robot->chipper_available();
+	}
+
+	std::vector<Gameplay::RoleRequirement> reqVec(len(reqs));
+	for (unsigned int i = 0; i < reqVec.size(); i++) {
+		boost::python::object py = reqs[i];
+		Gameplay::RoleRequirement &r = reqVec[i];
+
+		boost::python::object shape = py.attr("destination_shape");
+		if (shape.ptr() != Py_None) {
+			r.hasDestination = true;
+			boost::python::extract<Geometry2d::Point> pt(shape);
+			if (pt.check()) {
+				r.destination = Geometry2d::Segment(pt(), pt());
+			} else {
+				r.destination = boost::python::extract<Geometry2d::Segment>(shape);
+			}
+		}
+
+		r.hasBall = boost::python::extract<bool>(py.attr("has_ball"));
+		r.requireKicking = boost::python::extract<bool>(py.attr("require_kicking"));
+		r.chipperPreference = boost::python::extract<float>(py.attr("chipper_preference_weight"));
+
+		boost::python::object required = py.attr("required_shell_id");
+		if (required.ptr() != Py_None)
+			r.requiredShell = boost::python::extract<int>(required);
+
+		boost::python::object previous = py.attr("previous_shell_id");
+		if (previous.ptr() != Py_None)
+			r.previousShell = boost::python::extract<int>(previous);
+	}
+
+	std::vector<int> assignment;
+	if (!self->assign(candidates, reqVec, assignment))
+		return boost::python::object();
+
+	boost::python::list lst;
+	for (unsigned int i = 0; i < assignment.size(); i++) {
+		lst.append(assignment[i]);
+	}
+	return lst;
+}
+
 /**
  * The code in this block wraps up c++ classes and makes them
  * accessible to python in the 'robocup' module.
@@ -407,6 +644,55 @@ BOOST_PYTHON_MODULE(robocup)
 		.def_readonly("pos", &Ball::pos)
 		.def_readonly("vel", &Ball::vel)
 		.def_readonly("valid", &Ball::valid)
+		.def_readonly("sliding_speed", &Ball::slidingSpeed)
+		.def("trajectory", &Ball::trajectory, "predicted path of the ball if nothing touches it")
+	;
+
+	class_<BallTrajectory>("BallTrajectory", init<Geometry2d::Point, Geometry2d::Point, float>())
+		.def("__init__", make_constructor(&BallTrajectory_init))
+		.def("pos", &BallTrajectory::pos)
+		.def("vel", &BallTrajectory::vel)
+		.def("distance", &BallTrajectory::distance)
+		.def("time_to_reach", &BallTrajectory::timeToReach, "time for the ball to travel a distance, or inf if it stops first")
+		.def("stop_time", &BallTrajectory::stopTime)
+		.def("stop_distance", &BallTrajectory::stopDistance)
+		.def("positions", &BallTrajectory_positions, "positions of the ball at each of a list of times")
+		.def("times_to_reach", &BallTrajectory_times_to_reach, "time_to_reach() for each of a list of distances")
+		.def("intercepts", &BallTrajectory_intercepts, "(point, time) where each of a list of our robots can first get to the ball")
+	;
+
+	class_<Gameplay::Window>("Window", init<float, float>())
+		.def_readwrite("t0", &Gameplay::Window::t0)
+		.def_readwrite("t1", &Gameplay::Window::t1)
+		.def_readwrite("a0", &Gameplay::Window::a0)
+		.def_readwrite("a1", &Gameplay::Window::a1)
+		.def_readwrite("segment", &Gameplay::Window::segment)
+	;
+
+	class_<Gameplay::WindowEvaluator>("WindowEvaluator", init<>())
+		.def_readwrite("chip_enabled", &Gameplay::WindowEvaluator::chipEnabled)
+		.def_readwrite("min_chip_range", &Gameplay::WindowEvaluator::minChipRange)
+		.def_readwrite("max_chip_range", &Gameplay::WindowEvaluator::maxChipRange)
+		.def("set_obstacles", &WindowEvaluator_set_obstacles, "sets the positions of robots that block windows")
+		.def("eval_pt_to_seg", &WindowEvaluator_eval_pt_to_seg, "returns (windows, best window or None) from a point to a segment")
+		.def("eval_pts_to_seg", &WindowEvaluator_eval_pts_to_seg, "returns the best window (or None) from each of a list of points to a segment")
+	;
+
+	class_<Gameplay::RoleAssignment>("RoleAssignment", init<>())
+		.def("assign", &RoleAssignment_assign, "returns the index of the robot for each role requirement, or None if they can't be met")
+		.def("reset", &Gameplay::RoleAssignment::reset, "forgets the state kept from previous assignments")
+	;
+
+	class_<Gameplay::WorldSnapshot, boost::noncopyable>("WorldSnapshot", no_init)
+		.add_property("our_robots", &WorldSnapshot_our_robots, "tuple of our robots that plays may use")
+		.add_property("their_robots", &WorldSnapshot_their_robots, "tuple of visible opponents")
+		.add_property("ball", &WorldSnapshot_ball)
+		.add_property("game_state", &WorldSnapshot_game_state)
+		.add_property("system_state", make_function(&WorldSnapshot_system_state, return_value_policy<reference_existing_object>()))
+		.def("our_positions", &WorldSnapshot_our_positions, "positions of our_robots, in the same order")
+		.def("our_velocities", &WorldSnapshot_our_velocities, "velocities of our_robots, in the same order")
+		.def("their_positions", &WorldSnapshot_their_positions, "positions of their_robots, in the same order")
+		.def("their_velocities", &WorldSnapshot_their_velocities, "velocities of their_robots, in the same order")
 	;
 
 	class_<std::vector<OurRobot *> >("vector_OurRobot")
@@ -426,9 +712,9 @@ BOOST_PYTHON_MODULE(robocup)
 
 		//	debug drawing methods
 		.def("draw_circle", &State_draw_circle)
-		.def("draw_path", &SystemState::drawPath)
+		.def("draw_path", static_cast<void (SystemState::*)(const Planning::Path &, const QColor &, const QString &)>(&SystemState::drawPath))
 		.def("draw_text", &State_draw_text)
-		.def("draw_shape", &SystemState::drawShape)
+		.def("draw_shape", static_cast<void (SystemState::*)(const std::shared_ptr<Geometry2d::Shape> &, const QColor &, const QString &)>(&SystemState::drawShape))
 		.def("draw_line", &State_draw_line)
 		.def("draw_polygon", &State_draw_polygon)
 	;
@@ -1,4 +1,3 @@
-import munkres
 import evaluation.double_touch
 import robocup
 
@@ -116,22 +115,21 @@ def iterate_role_requirements_tree_leaves(reqs_tree):
 class ImpossibleAssignmentError(RuntimeError): pass
 
 
-# the munkres library doesn't like infinity, so we use this instead
+# the cost of a robot that doesn't meet a hard requirement of a role
+# the other costs are in RoleAssignment.cpp, which computes the cost matrix
 MaxWeight = 10000000
 
 
-# multiply this by the distance between two points to get the cost
-PositionCostMultiplier = 1.0
-
-# how much penalty is there for switching robots mid-play
-RobotChangeCost = 1.0
-
 # a default weight for preferring a chipper
 # this is tunable
 PreferChipper = 2.5
 
 
-# uses the munkres/hungarian algorithm to find the optimal role assignments
+# the assignment engine is native and keeps state between frames to warm-start each solve
+_solver = robocup.RoleAssignment()
+
+
+# uses the hungarian algorithm to find the optimal role assignments
 # works by building a cost matrix for reach robot, role pair, then choosing the assignments to minimize total cost
 # If no restraint-satisfying mass assignment exists, throws an ImpossibleAssignmentError
 #
@@ -182,34 +180,10 @@ def assign_roles(robots, role_reqs):
         return {}
 
 
-    # build the cost matrix
-    cost_matrix = []
-    for robot in robots:
-        cost_row = []
-        for req in role_reqs_list:
-            cost = 0
-
-            if req.required_shell_id != None and req.required_shell_id != robot.shell_id():
-                cost = MaxWeight
-            elif req.has_ball == True and robot.has_ball() == False:
-                cost = MaxWeight
-            elif req.require_kicking and (robot.shell_id() == evaluation.double_touch.tracker().forbidden_ball_toucher() or not robot.kicker_works() or not robot.ball_sense_works()):
-                cost = MaxWeight
-            else:
-                if req.destination_shape != None:
-                    cost += PositionCostMultiplier * req.destination_shape.dist_to(robot.pos)
-                if req.previous_shell_id != None and req.previous_shell_id != robot.shell_id:
-                    cost += RobotChangeCost
-                if not robot.has_chipper():
-                    cost += req.chipper_preference_weight
-
-            cost_row.append(cost)
-        cost_matrix.append(cost_row)
-
-
-    # solve
-    solver = munkres.Munkres()
-    indexes = solver.compute(cost_matrix)
+    # build the cost matrix and solve it
+    indexes = _solver.assign(robots, role_reqs_list, evaluation.double_touch.tracker().forbidden_ball_toucher())
+    if indexes == None:
+        raise ImpossibleAssignmentError("No assignments possible that satisfy all constraints")
 
 
     results = {}
@@ -226,16 +200,9 @@ def assign_roles(robots, role_reqs):
 
 
     # build assignments mapping
-    assignments = {}
-    total = 0
-    for row, col in indexes:
-        total += cost_matrix[row][col]
-
-        bot = robots[row]
-        reqs = role_reqs_list[col]
-
+    for reqs, row in zip(role_reqs_list, indexes):
         # add entry to results tree
-        insert_into_results(results, tree_mapping, reqs, bot)
+        insert_into_results(results, tree_mapping, reqs, robots[row])
 
 
     # insert None for each role that we didn't assign
@@ -243,7 +210,4 @@ def assign_roles(robots, role_reqs):
         insert_into_results(results, tree_mapping, reqs, None)
 
 
-    if total > MaxWeight:
-        raise ImpossibleAssignmentError("No assignments possible that satisfy all constraints")
-
     return results
@@ -69,11 +69,12 @@ class Capture(single_robot_behavior.SingleRobotBehavior):
         approach_vec = self.approach_vector()
 
         # sample every 5 cm in the -approach_vector direction from the ball
+        dists = [i * 0.05 for i in range(50)]
+        # how long will it take the ball to get to each point
+        ball_times = main.ball().trajectory().times_to_reach([d - Capture.CourseApproachDist for d in dists])
         pos = None
-        for i in range(50):
-            dist = i * 0.05
+        for dist, ball_time in zip(dists, ball_times):
             pos = main.ball().pos + approach_vec * dist
-            ball_time = evaluation.ball.rev_predict(main.ball().vel, dist - Capture.CourseApproachDist) # how long will it take the ball to get there
             bot_time = (pos - self.robot.pos).mag() * 10.0 # FIXME: evaluate trapezoid
 
             # print('bot: ' + str(bot_time) + ';; ball: ' + str(ball_time))
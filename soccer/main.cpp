@@ -125,6 +125,9 @@ void usage(const char* prog)
 	fprintf(stderr, "\t-pp <play>: enable named play\n");
 	fprintf(stderr, "\t-ng:        no goalie\n");
 	fprintf(stderr, "\t-sim:       use simulator\n");
+	fprintf(stderr, "\t-lockstep:  with -sim, run on simulated time stepped by vision from a headless simulator\n");
+	fprintf(stderr, "\t-vt:        start each frame when vision arrives instead of on a fixed period\n");
+	fprintf(stderr, "\t-competition: skip all debug drawing\n");
 	fprintf(stderr, "\t-freq:      specify radio frequency (906 or 904)\n");
 	fprintf(stderr, "\t-nolog:     don't write log files\n");
 	exit(1);
@@ -161,6 +164,9 @@ int main (int argc, char* argv[])
 	vector<QString> extraPlays;
 	bool goalie = true;
 	bool sim = false;
+	bool lockstep = false;
+	bool visionTriggered = false;
+	bool competition = false;
 	bool log = true;
     QString radioFreq;
 	
@@ -187,6 +193,18 @@ int main (int argc, char* argv[])
 		{
 			sim = true;
 		}
+		else if (strcmp(var, "-lockstep") == 0)
+		{
+			lockstep = true;
+		}
+		else if (strcmp(var, "-vt") == 0)
+		{
+			visionTriggered = true;
+		}
+		else if (strcmp(var, "-competition") == 0)
+		{
+			competition = true;
+		}
 		else if (strcmp(var, "-nolog") == 0)
 		{
 			log = false;
@@ -271,8 +289,10 @@ int main (int argc, char* argv[])
 		obj->createConfiguration(&config);
 	}
 
-	Processor *processor = new Processor(sim);
+	Processor *processor = new Processor(sim, lockstep);
 	processor->blueTeam(blueTeam);
+	processor->visionTriggered(visionTriggered);
+	processor->state()->competitionMode(competition);
 	
 	// Load config file
 	QString error;
@@ -4,42 +4,202 @@
 #include <SystemState.hpp>
 
 #include <stdio.h>
+#include <math.h>
+#include <algorithm>
 
+using namespace std;
+using namespace Eigen;
 using namespace Geometry2d;
 
-static const float Velocity_Alpha = 0.2;
+// Standard deviation of vision measurements of the ball
+static const float Vision_Pos_Stddev = 0.01;	// m
+
+// Standard deviation of acceleration not explained by friction
+static const float Accel_Stddev = 1;			// m/s^2
+
+// Uncertainty in velocity when a ball is first seen or may have been kicked
+static const float Initial_Vel_Stddev = 1;		// m/s
+static const float Kick_Vel_Stddev = 4;			// m/s
+
+// Prior probability that the ball was kicked or hit something between two observations
+static const float Kick_Probability = 0.01;
+
+// Hypotheses beyond this many, or less likely than this, are dropped
+static const unsigned int Max_Hypotheses = 4;
+static const float Min_Weight = 1e-4;
+
+// A new kick hypothesis re-estimates its sliding speed from this many observations
+static const int Kick_Settle_Updates = 3;
 
 BallFilter::BallFilter()
 {
+	_time = 0;
+}
+
+void BallFilter::propagate(float dt, Hypothesis &h)
+{
+	if (dt <= 0)
+	{
+		return;
+	}
+	
+	// The mean follows the friction model
+	BallTrajectory path(Point(h.x(0), h.x(1)), Point(h.x(2), h.x(3)), h.slidingSpeed);
+	Point pos = path.pos(dt);
+	Point vel = path.vel(dt);
+	h.x << pos.x, pos.y, vel.x, vel.y;
+	if (vel.mag() <= h.slidingSpeed)
+	{
+		h.slidingSpeed = 0;
+	}
+	
+	// Covariance uses the constant-velocity linearization with white acceleration noise
+	Matrix4f F = Matrix4f::Identity();
+	F(0, 2) = F(1, 3) = dt;
+	
+	float q = Accel_Stddev * Accel_Stddev;
+	float dt2 = dt * dt;
+	Matrix4f Q = Matrix4f::Zero();
+	Q(0, 0) = Q(1, 1) = dt2 * dt2 / 4 * q;
+	Q(0, 2) = Q(2, 0) = Q(1, 3) = Q(3, 1) = dt2 * dt / 2 * q;
+	Q(2, 2) = Q(3, 3) = dt2 * q;
+	
+	h.P = F * h.P * F.transpose() + Q;
+}
+
+float BallFilter::correct(Hypothesis &h, const BallObservation *obs)
+{
+	Matrix<float, 2, 4> H = Matrix<float, 2, 4>::Zero();
+	H(0, 0) = H(1, 1) = 1;
+	
+	Matrix2f R = Matrix2f::Identity() * (Vision_Pos_Stddev * Vision_Pos_Stddev);
+	
+	Vector2f y(obs->pos.x - h.x(0), obs->pos.y - h.x(1));
+	Matrix2f S = H * h.P * H.transpose() + R;
+	Matrix2f Sinv = S.inverse();
+	Matrix<float, 4, 2> K = h.P * H.transpose() * Sinv;
+	
+	h.x += K * y;
+	h.P = (Matrix4f::Identity() - K * H) * h.P;
+	++h.updates;
+	
+	// Gaussian likelihood of the innovation
+	float d2 = y.dot(Sinv * y);
+	return expf(-d2 / 2) / (2 * M_PI * sqrtf(S.determinant()));
+}
+
+int BallFilter::best() const
+{
+	int b = 0;
+	for (unsigned int i = 1; i < _hypotheses.size(); ++i)
+	{
+		if (_hypotheses[i].weight > _hypotheses[b].weight)
+		{
+			b = i;
+		}
+	}
+	return b;
+}
+
+bool BallFilter::kicked() const
+{
+	return !_hypotheses.empty() && _hypotheses[best()].kicked;
 }
 
 void BallFilter::update(const BallObservation* obs)
 {
-	if (_estimate.time)
+	if (_hypotheses.empty())
+	{
+		Hypothesis h;
+		h.x << obs->pos.x, obs->pos.y, 0, 0;
+		h.P = Covariance::Zero();
+		h.P(0, 0) = h.P(1, 1) = Vision_Pos_Stddev * Vision_Pos_Stddev;
+		h.P(2, 2) = h.P(3, 3) = Initial_Vel_Stddev * Initial_Vel_Stddev;
+		h.slidingSpeed = 0;
+		h.weight = 1;
+		h.kicked = false;
+		h.updates = 0;
+		_hypotheses.push_back(h);
+		_time = obs->time;
+		return;
+	}
+	
+	float dt = obs->time > _time ? (obs->time - _time) / 1000000.0f : 0;
+	_time = max(_time, obs->time);
+	
+	// Something may have changed the ball's velocity since the last observation
+	Hypothesis kick = _hypotheses[best()];
+	kick.P(2, 2) += Kick_Vel_Stddev * Kick_Vel_Stddev;
+	kick.P(3, 3) += Kick_Vel_Stddev * Kick_Vel_Stddev;
+	kick.slidingSpeed = 0;
+	kick.weight = Kick_Probability;
+	kick.kicked = true;
+	kick.updates = 0;
+	
+	for (unsigned int i = 0; i < _hypotheses.size(); ++i)
 	{
-		float dtime = (obs->time - _estimate.time) / 1000000.0f;
-		Point newVel = (obs->pos - _estimate.pos) / dtime;
-		_estimate.vel = newVel * Velocity_Alpha + _estimate.vel * (1.0f - Velocity_Alpha);
-		_estimate.valid = true;
-	} else {
-		_estimate.vel = Point();
+		_hypotheses[i].weight *= 1 - Kick_Probability;
 	}
+	_hypotheses.push_back(kick);
 	
-	_estimate.pos = obs->pos;
-	_estimate.time = obs->time;
+	float total = 0;
+	for (unsigned int i = 0; i < _hypotheses.size(); ++i)
+	{
+		Hypothesis &h = _hypotheses[i];
+		propagate(dt, h);
+		h.weight *= max(correct(h, obs), 1e-30f);
+		
+		// A kicked ball starts out sliding
+		if (h.kicked && h.updates <= Kick_Settle_Updates)
+		{
+			h.slidingSpeed = Ball_RollingSpeedFraction * Point(h.x(2), h.x(3)).mag();
+		}
+		
+		total += h.weight;
+	}
+	
+	// Normalize and keep the most likely hypotheses
+	for (unsigned int i = 0; i < _hypotheses.size(); ++i)
+	{
+		_hypotheses[i].weight /= total;
+	}
+	sort(_hypotheses.begin(), _hypotheses.end(),
+		[](const Hypothesis &a, const Hypothesis &b)
+		{
+			return a.weight > b.weight;
+		});
+	while (_hypotheses.size() > 1 && (_hypotheses.size() > Max_Hypotheses || _hypotheses.back().weight < Min_Weight))
+	{
+		_hypotheses.pop_back();
+	}
 }
 
 void BallFilter::predict(uint64_t time, Ball *out, float *velocityUncertainty)
 {
+	if (_hypotheses.empty())
+	{
+		if (out)
+		{
+			out->valid = false;
+		}
+		return;
+	}
+	
+	const Hypothesis &h = _hypotheses[best()];
+	Point vel(h.x(2), h.x(3));
+	
 	if (velocityUncertainty)
 	{
-		*velocityUncertainty = 2 + _estimate.vel.mag() * 0.5;
+		*velocityUncertainty = 2 + vel.mag() * 0.5;
 	}
 
 	if (out)
 	{
-		out->pos = _estimate.pos + _estimate.vel * (time - _estimate.time) / 1000000.0f;
-		out->vel = _estimate.vel;
+		float dt = time > _time ? (time - _time) / 1000000.0f : 0;
+		BallTrajectory path(Point(h.x(0), h.x(1)), vel, h.slidingSpeed);
+		out->pos = path.pos(dt);
+		out->vel = path.vel(dt);
+		out->slidingSpeed = out->vel.mag() > h.slidingSpeed ? h.slidingSpeed : 0;
 		out->time = time;
 		out->valid = true;
 	}
@@ -2,13 +2,29 @@
 
 #include <SystemState.hpp>
 
+#include <Eigen/Dense>
+#include <vector>
 #include <stdint.h>
 
 class Ball;
 class BallObservation;
 
-// A BallFilter never needs to reset itself.  The BallTracker will
-// create a new one when a new ball is found.
+/**
+ * Estimates the ball's motion with a small bank of Kalman filters, one per hypothesis
+ * about what has happened to the ball.
+ *
+ * Between observations the ball follows BallTrajectory (sliding, then rolling with friction).
+ * On every observation a new hypothesis is started from the most likely one with its velocity
+ * unknown, in case the ball was just kicked or hit something.  Hypotheses are weighted by how well
+ * they explain the observations and unlikely ones are dropped, so after a kick the new hypothesis
+ * quickly takes over without the lag of smoothing over the change in velocity.
+ *
+ * This is a simplified form of the retired particle filter in modeling/old/rbpf,
+ * which used separate rolling and kicked models.
+ *
+ * A BallFilter never needs to reset itself.  The BallTracker will
+ * create a new one when a new ball is found.
+ */
 class BallFilter
 {
 public:
@@ -20,6 +36,49 @@ public:
 	// Generates a prediction of the ball's state at a given time in the future
 	void predict(uint64_t time, Ball *out, float *velocityUncertainty);
 	
+	/// Number of hypotheses being tracked
+	int numHypotheses() const
+	{
+		return _hypotheses.size();
+	}
+	
+	/// True if the most likely hypothesis started with a kick or collision
+	bool kicked() const;
+	
 private:
-	Ball _estimate;
+	// Unaligned so hypotheses can be stored in a std::vector
+	typedef Eigen::Matrix<float, 4, 1, Eigen::DontAlign> State;
+	typedef Eigen::Matrix<float, 4, 4, Eigen::DontAlign> Covariance;
+	
+	/// State is [x, y, vx, vy]
+	struct Hypothesis
+	{
+		State x;
+		Covariance P;
+		
+		/// See Ball::slidingSpeed
+		float slidingSpeed;
+		
+		float weight;
+		
+		/// True if this hypothesis started with a kick or collision
+		bool kicked;
+		
+		/// Number of observations since this hypothesis started
+		int updates;
+	};
+	
+	/// Moves a hypothesis forward by @dt seconds
+	static void propagate(float dt, Hypothesis &h);
+	
+	/// Applies an observation to a hypothesis and returns its likelihood
+	static float correct(Hypothesis &h, const BallObservation *obs);
+	
+	/// Index of the most likely hypothesis
+	int best() const;
+	
+	std::vector<Hypothesis> _hypotheses;
+	
+	/// Time of the last observation, or zero before the first one
+	uint64_t _time;
 };
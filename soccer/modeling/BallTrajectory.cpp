@@ -0,0 +1,151 @@
+#include "BallTrajectory.hpp"
+
+#include <Constants.hpp>
+
+#include <math.h>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+using namespace Geometry2d;
+
+// Spacing of the times checked by interceptTime
+static const float Intercept_Step = 1.0f / 60;
+
+BallTrajectory::BallTrajectory(Point pos, Point vel, float slidingSpeed):
+	_pos(pos)
+{
+	_speed = vel.mag();
+	_dir = _speed > 0 ? vel / _speed : Point();
+
+	if (slidingSpeed > 0 && slidingSpeed < _speed)
+	{
+		_rollSpeed = slidingSpeed;
+		_slideTime = (_speed - slidingSpeed) / Ball_SlidingDecel;
+	} else {
+		_rollSpeed = _speed;
+		_slideTime = 0;
+	}
+	_rollTime = _rollSpeed / Ball_RollingDecel;
+}
+
+float BallTrajectory::distance(float t) const
+{
+	if (t <= 0)
+	{
+		return 0;
+	}
+
+	if (t <= _slideTime)
+	{
+		return _speed * t - Ball_SlidingDecel * t * t / 2;
+	}
+
+	float slid = (_speed + _rollSpeed) / 2 * _slideTime;
+	float r = min(t - _slideTime, _rollTime);
+	return slid + _rollSpeed * r - Ball_RollingDecel * r * r / 2;
+}
+
+float BallTrajectory::stopDistance() const
+{
+	return (_speed + _rollSpeed) / 2 * _slideTime + _rollSpeed * _rollTime / 2;
+}
+
+Point BallTrajectory::pos(float t) const
+{
+	return _pos + _dir * distance(t);
+}
+
+Point BallTrajectory::vel(float t) const
+{
+	float speed;
+	if (t <= _slideTime)
+	{
+		speed = _speed - Ball_SlidingDecel * max(t, 0.0f);
+	} else {
+		speed = max(0.0f, _rollSpeed - Ball_RollingDecel * (t - _slideTime));
+	}
+	return _dir * speed;
+}
+
+void BallTrajectory::positions(const vector<float> &times, vector<Point> &out) const
+{
+	out.resize(times.size());
+	for (unsigned int i = 0; i < times.size(); ++i)
+	{
+		out[i] = pos(times[i]);
+	}
+}
+
+float BallTrajectory::timeToReach(float dist) const
+{
+	if (dist <= 0)
+	{
+		return 0;
+	}
+
+	// Solve d = v*t - a*t^2/2 in whichever phase the distance is reached
+	float slid = (_speed + _rollSpeed) / 2 * _slideTime;
+	if (dist <= slid)
+	{
+		return (_speed - sqrtf(max(0.0f, _speed * _speed - 2 * Ball_SlidingDecel * dist))) / Ball_SlidingDecel;
+	}
+
+	float r = dist - slid;
+	float disc = _rollSpeed * _rollSpeed - 2 * Ball_RollingDecel * r;
+	if (_rollSpeed <= 0 || disc < 0)
+	{
+		return numeric_limits<float>::infinity();
+	}
+	return _slideTime + (_rollSpeed - sqrtf(disc)) / Ball_RollingDecel;
+}
+
+void BallTrajectory::timesToReach(const vector<float> &dists, vector<float> &out) const
+{
+	out.resize(dists.size());
+	for (unsigned int i = 0; i < dists.size(); ++i)
+	{
+		out[i] = timeToReach(dists[i]);
+	}
+}
+
+float BallTrajectory::travelTime(float dist, float maxSpeed, float maxAcceleration)
+{
+	if (dist <= 0)
+	{
+		return 0;
+	}
+
+	if (dist < maxSpeed * maxSpeed / maxAcceleration)
+	{
+		// Never reaches full speed
+		return 2 * sqrtf(dist / maxAcceleration);
+	}
+
+	return dist / maxSpeed + maxSpeed / maxAcceleration;
+}
+
+float BallTrajectory::interceptTime(Point start, float maxSpeed, float maxAcceleration, Point *where) const
+{
+	float stop = stopTime();
+	for (float t = 0; t < stop; t += Intercept_Step)
+	{
+		Point ball = pos(t);
+		if (travelTime((ball - start).mag(), maxSpeed, maxAcceleration) <= t)
+		{
+			if (where)
+			{
+				*where = ball;
+			}
+			return t;
+		}
+	}
+
+	// Meet the ball where it stops
+	Point ball = pos(stop);
+	if (where)
+	{
+		*where = ball;
+	}
+	return max(stop, travelTime((ball - start).mag(), maxSpeed, maxAcceleration));
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Geometry2d/Point.hpp>
+
+#include <vector>
+
+/**
+ * Path of a free ball under friction.
+ *
+ * A kicked ball first slides, decelerating at Ball_SlidingDecel, until its speed drops to slidingSpeed.
+ * After that it rolls, decelerating at Ball_RollingDecel, until it stops.
+ * A slidingSpeed of zero (or at least the initial speed) means the ball is already rolling.
+ *
+ * Times are in seconds from the start of the trajectory.
+ * This is cheap to copy and evaluate, so plays can query many times per frame.
+ */
+class BallTrajectory
+{
+public:
+	BallTrajectory(Geometry2d::Point pos = Geometry2d::Point(), Geometry2d::Point vel = Geometry2d::Point(), float slidingSpeed = 0);
+
+	Geometry2d::Point pos(float t) const;
+	Geometry2d::Point vel(float t) const;
+
+	/// Evaluates pos() at each time in @times
+	void positions(const std::vector<float> &times, std::vector<Geometry2d::Point> &out) const;
+
+	/// Distance traveled after @t seconds
+	float distance(float t) const;
+
+	/// Time to travel @dist meters, or infinity if the ball stops first
+	float timeToReach(float dist) const;
+
+	/// Evaluates timeToReach() at each distance in @dists
+	void timesToReach(const std::vector<float> &dists, std::vector<float> &out) const;
+
+	/// Finds the earliest time that a robot starting at rest at @start can get to the ball.
+	/// Stores where it meets the ball in @where.
+	float interceptTime(Geometry2d::Point start, float maxSpeed, float maxAcceleration, Geometry2d::Point *where) const;
+
+	/// Time for a robot to travel @dist from rest to rest, accelerating and decelerating at @maxAcceleration
+	static float travelTime(float dist, float maxSpeed, float maxAcceleration);
+
+	/// Time when the ball stops
+	float stopTime() const
+	{
+		return _slideTime + _rollTime;
+	}
+
+	/// Distance traveled by the time the ball stops
+	float stopDistance() const;
+
+private:
+	Geometry2d::Point _pos;
+
+	/// Direction of travel (zero if stopped) and initial speed
+	Geometry2d::Point _dir;
+	float _speed;
+
+	/// Speed at the end of sliding
+	float _rollSpeed;
+
+	/// Duration of each phase
+	float _slideTime;
+	float _rollTime;
+};
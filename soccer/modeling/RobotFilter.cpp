@@ -3,70 +3,134 @@
 #include <iostream>
 
 using namespace Geometry2d;
+using namespace Eigen;
 
 // How long to coast a robot's position when it isn't visible
 static const float Coast_Time = 0.8;
-static const float Velocity_Alpha = 0.2;
-static const float Min_Frame_Time = 0.014;
+
+// Standard deviation of vision measurements
+static const float Vision_Pos_Stddev = 0.005;		// m
+static const float Vision_Angle_Stddev = 0.03;		// rad
+
+// Standard deviation of the acceleration that the constant-velocity model doesn't account for
+static const float Accel_Stddev = 4;				// m/s^2
+static const float Angular_Accel_Stddev = 40;		// rad/s^2
+
+// Uncertainty in velocity when a robot is first seen
+static const float Initial_Vel_Stddev = 2;			// m/s
+static const float Initial_AngleVel_Stddev = 10;	// rad/s
 
 RobotFilter::RobotFilter()
 {
-	_camera = -1;
+	_x.setZero();
+	_P.setIdentity();
+	_time = 0;
+	_visionFrame = 0;
+}
+
+void RobotFilter::reset(const RobotObservation* obs)
+{
+	_x << obs->pos.x, obs->pos.y, obs->angle, 0, 0, 0;
+
+	_P.setZero();
+	_P(0, 0) = _P(1, 1) = Vision_Pos_Stddev * Vision_Pos_Stddev;
+	_P(2, 2) = Vision_Angle_Stddev * Vision_Angle_Stddev;
+	_P(3, 3) = _P(4, 4) = Initial_Vel_Stddev * Initial_Vel_Stddev;
+	_P(5, 5) = Initial_AngleVel_Stddev * Initial_AngleVel_Stddev;
+}
+
+void RobotFilter::propagate(float dt, State &x, Covariance &P)
+{
+	// Constant velocity
+	Covariance F = Covariance::Identity();
+	F(0, 3) = F(1, 4) = F(2, 5) = dt;
+
+	x = F * x;
+	x(2) = fixAngleRadians(x(2));
+
+	// Process noise from white acceleration
+	float dt2 = dt * dt;
+	float pp = dt2 * dt2 / 4;
+	float pv = dt2 * dt / 2;
+	float vv = dt2;
+	const float qa[3] =
+	{
+		Accel_Stddev * Accel_Stddev,
+		Accel_Stddev * Accel_Stddev,
+		Angular_Accel_Stddev * Angular_Accel_Stddev
+	};
+
+	Covariance Q = Covariance::Zero();
+	for (int i = 0; i < 3; ++i)
+	{
+		Q(i, i) = pp * qa[i];
+		Q(i, i + 3) = Q(i + 3, i) = pv * qa[i];
+		Q(i + 3, i + 3) = vv * qa[i];
+	}
+
+	P = F * P * F.transpose() + Q;
 }
 
 void RobotFilter::update(const RobotObservation* obs)
 {
-	if (obs->source < 0 || obs->source >= Num_Cameras)
+	if (obs->source < 0)
 	{
 		// Not from a camera?
 		return;
 	}
-	
-	int s = obs->source;
-	double dtime = (obs->time - _estimate[s].time) / 1000000.0f;
-	bool reset = _estimate[s].time == 0 || (dtime > Coast_Time);
-	
-	if (reset || dtime < Min_Frame_Time)
+
+	_visionFrame = obs->frameNumber;
+
+	if (_time == 0 || (obs->time > _time && (obs->time - _time) / 1000000.0f > Coast_Time))
 	{
-		_estimate[s].vel = Point();
-		_estimate[s].angleVel = 0;
-	} else {
-		Point newVel = (obs->pos - _estimate[s].pos) / dtime;
-		_estimate[s].vel = newVel * Velocity_Alpha + _estimate[s].vel * (1.0f - Velocity_Alpha);
-		
-		double newW = fixAngleDegrees(obs->angle - _estimate[s].angle) / dtime;
-		_estimate[s].angleVel = newW * Velocity_Alpha + _estimate[s].angleVel * (1.0f - Velocity_Alpha);
+		reset(obs);
+		_time = obs->time;
+		return;
 	}
-	_estimate[s].pos = obs->pos;
-	_estimate[s].angle = obs->angle;
-	_estimate[s].visible = true;
-	_estimate[s].time = obs->time;
-	_estimate[s].visionFrame = obs->frameNumber;
-}
 
-void RobotFilter::predict(uint64_t time, Robot* robot)
-{
-	int bestSource = -1;
-	double bestDTime = 0;
-	for (int s = 0; s < Num_Cameras; ++s)
+	if (obs->time > _time)
 	{
-		double dtime = (time - _estimate[s].time) / 1000000.0f;
-		if (_estimate[s].visible && (bestSource < 0 || dtime < bestDTime))
-		{
-			bestSource = s;
-			bestDTime = dtime;
-		}
+		propagate((obs->time - _time) / 1000000.0f, _x, _P);
+		_time = obs->time;
 	}
-	
-	if (bestSource < 0)
+
+	// Position and angle are measured directly
+	Matrix<float, 3, 6> H = Matrix<float, 3, 6>::Zero();
+	H(0, 0) = H(1, 1) = H(2, 2) = 1;
+
+	Matrix3f R = Matrix3f::Zero();
+	R(0, 0) = R(1, 1) = Vision_Pos_Stddev * Vision_Pos_Stddev;
+	R(2, 2) = Vision_Angle_Stddev * Vision_Angle_Stddev;
+
+	Vector3f y(obs->pos.x - _x(0), obs->pos.y - _x(1), fixAngleRadians(obs->angle - _x(2)));
+
+	Matrix3f S = H * _P * H.transpose() + R;
+	Matrix<float, 6, 3> K = _P * H.transpose() * S.inverse();
+
+	_x += K * y;
+	_x(2) = fixAngleRadians(_x(2));
+	_P = (Covariance::Identity() - K * H) * _P;
+}
+
+void RobotFilter::predict(uint64_t time, RobotPose* robot)
+{
+	if (_time == 0)
 	{
 		robot->visible = false;
 		return;
 	}
-	
-	robot->pos = _estimate[bestSource].pos + _estimate[bestSource].vel * bestDTime;
-	robot->vel = _estimate[bestSource].vel;
-	robot->angle = fixAngleDegrees(_estimate[bestSource].angle + _estimate[bestSource].angleVel * bestDTime);
-	robot->angleVel = _estimate[bestSource].angleVel;
-	robot->visible = _estimate[bestSource].visible && bestDTime < Coast_Time;
+
+	float dtime = time > _time ? (time - _time) / 1000000.0f : 0;
+
+	State x = _x;
+	Covariance P = _P;
+	propagate(dtime, x, P);
+
+	robot->pos = Point(x(0), x(1));
+	robot->vel = Point(x(3), x(4));
+	robot->angle = x(2);
+	robot->angleVel = x(5);
+	robot->time = time;
+	robot->visionFrame = _visionFrame;
+	robot->visible = dtime < Coast_Time;
 }
@@ -2,6 +2,8 @@
 
 #include <Robot.hpp>
 
+#include <Eigen/Dense>
+
 class RobotObservation
 {
 public:
@@ -15,7 +17,7 @@ public:
 	uint64_t time;
 	int source;
 	int frameNumber;
-	
+
 	// Compares the times on two observations.  Used for sorting.
 	bool operator<(const RobotObservation &other) const
 	{
@@ -23,26 +25,54 @@ public:
 	}
 };
 /**
- * adjusts robot vision for accuracy
+ * Tracks one robot with a constant-velocity Kalman filter.
+ *
+ * Observations from every camera update the same estimate, so there is no jump when a robot
+ * moves from one camera to another and overlapping cameras improve the estimate.
+ * Observations should be given in order of capture time.
+ * One that is older than the current estimate is applied as if it was taken at the time of the estimate.
+ *
+ * The state is [x, y, angle, vx, vy, angleVel] in team space.
  */
 class RobotFilter
 {
 public:
+	// The covariance is a fixed-size vectorizable Eigen type
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	typedef Eigen::Matrix<float, 6, 1> State;
+	typedef Eigen::Matrix<float, 6, 6> Covariance;
+
 	RobotFilter();
-	
+
 	/// Gives a new observation to the filter
 	void update(const RobotObservation *obs);
-	
-	/// Generates a prediction of the ball's state at a given time in the future.
+
+	/// Generates a prediction of the robot's state at a given time in the future.
 	/// This may clear robot->visible if the prediction is too long in the future to be reliable.
-	void predict(uint64_t time, Robot *robot);
+	void predict(uint64_t time, RobotPose *robot);
+
+	const State &state() const
+	{
+		return _x;
+	}
+
+	const Covariance &covariance() const
+	{
+		return _P;
+	}
 
 private:
-	static const int Num_Cameras = 2;
-	
-	/// Estimate for each camera
-	RobotPose _estimate[Num_Cameras];
-	
-	/// Which camera we are using to track this robot, or -1 if it has not been seen recently
-	int _camera;
+	/// Moves @x and @P forward by @dt seconds
+	static void propagate(float dt, State &x, Covariance &P);
+
+	/// Starts tracking from a single observation
+	void reset(const RobotObservation *obs);
+
+	State _x;
+	Covariance _P;
+
+	/// Time of the estimate, or zero if the robot has not been seen
+	uint64_t _time;
+	int _visionFrame;
 };
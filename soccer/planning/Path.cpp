@@ -84,17 +84,14 @@ bool Planning::Path::hit(const Geometry2d::CompositeShape &obstacles, unsigned i
     }
     
     // The set of obstacles the starting point was inside of
-    std::set<std::shared_ptr<Geometry2d::Shape> > hit;
+    Geometry2d::CompositeShape::HitSet hit;
     obstacles.hit(points[start], hit);
     
     for (unsigned int i = start; i < (points.size() - 1); ++i)
     {
-        std::set<std::shared_ptr<Geometry2d::Shape> > newHit;
+        Geometry2d::CompositeShape::HitSet newHit;
         obstacles.hit(Geometry2d::Segment(points[i], points[i + 1]), newHit);
-        try
-        {
-            set_difference(newHit.begin(), newHit.end(), hit.begin(), hit.end(), ExceptionIterator<std::shared_ptr<Geometry2d::Shape>>());
-        } catch (exception& e)
+        if (Geometry2d::CompositeShape::hitsNewObstacle(newHit, hit))
         {
             // Going into a new obstacle
             return true;
@@ -21,9 +21,23 @@ Geometry2d::Point Planning::randomPoint()
 	return Geometry2d::Point(x, y);
 }
 
+Geometry2d::Point Planning::randomPoint(unsigned short randState[3])
+{
+	float x = Floor_Width * (erand48(randState) - 0.5f);
+	float y = Floor_Length * erand48(randState) - Field_Border;
+
+	return Geometry2d::Point(x, y);
+}
+
 RRTPlanner::RRTPlanner()
 {
 	_maxIterations = 100;
+
+	// Seed from the global generator so runs are still repeatable with srand48()
+	long seed = lrand48();
+	_randState[0] = 0x330E;
+	_randState[1] = seed & 0xffff;
+	_randState[2] = (seed >> 16) & 0xffff;
 }
 
 void RRTPlanner::run(
@@ -52,22 +66,21 @@ void RRTPlanner::run(
 
 	if (obstacles && obstacles->hit(goal))
 	{
-		FixedStepTree goalTree;
-		goalTree.init(goal, obstacles);
-		goalTree.step = .1f;
+		_goalTree.init(goal, obstacles);
+		_goalTree.step = .1f;
 
 		// The starting point is in an obstacle
 		// extend the tree until we find an unobstructed point
 		for (int i= 0 ; i< 100 ; ++i)
 		{
-			Geometry2d::Point r = randomPoint();
+			Geometry2d::Point r = randomPoint(_randState);
 
 			//extend to a random point
-			Tree::Point* newPoint = goalTree.extend(r);
+			Tree::Point* newPoint = _goalTree.extend(r);
 
 			//if the new point is not blocked
 			//it becomes the new goal
-			if (newPoint && newPoint->hit.empty())
+			if (newPoint && newPoint->hit.none())
 			{
 				newGoal = newPoint->pos;
 				break;
@@ -107,7 +120,7 @@ void RRTPlanner::run(
 
 	for (unsigned int i=0 ; i<_maxIterations; ++i)
 	{
-		Geometry2d::Point r = randomPoint();
+		Geometry2d::Point r = randomPoint(_randState);
 
 		Tree::Point* newPoint = ta->extend(r);
 
@@ -206,7 +219,7 @@ void RRTPlanner::optimize(Planning::Path &path, const Geometry2d::CompositeShape
 	pts.insert(pts.end(), begin, begin + start);
 
 	// The set of obstacles the starting point was inside of
-	std::set<shared_ptr<Geometry2d::Shape> > hit;
+	Geometry2d::CompositeShape::HitSet hit;
 
 	again:
 	obstacles->hit(path.points[start], hit);
@@ -214,12 +227,9 @@ void RRTPlanner::optimize(Planning::Path &path, const Geometry2d::CompositeShape
 	// [start, start + 1] is guaranteed not to have a collision because it's already in the path.
 	for (unsigned int end = start + 2; end < path.points.size(); ++end)
 	{
-		std::set<shared_ptr<Geometry2d::Shape> > newHit;
+		Geometry2d::CompositeShape::HitSet newHit;
 		obstacles->hit(Geometry2d::Segment(path.points[start], path.points[end]), newHit);
-		try
-		{
-			set_difference(newHit.begin(), newHit.end(), hit.begin(), hit.end(), ExceptionIterator<std::shared_ptr<Geometry2d::Shape>>());
-		} catch (exception& e)
+		if (Geometry2d::CompositeShape::hitsNewObstacle(newHit, hit))
 		{
 			start = end - 1;
 			goto again;
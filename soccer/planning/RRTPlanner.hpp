@@ -12,6 +12,10 @@ namespace Planning
 {
 	/** generate a random point on the floor */
 	Geometry2d::Point randomPoint();
+	
+	/** generate a random point on the floor using a private random state for erand48().
+	 *  This doesn't touch the global drand48() state, so it is safe to call from several threads */
+	Geometry2d::Point randomPoint(unsigned short randState[3]);
 	/**
 	 * RRT: http://en.wikipedia.org/wiki/Rapidly-exploring_random_tree
 	 * this plans the motion path for the robot
@@ -52,6 +56,10 @@ namespace Planning
 		FixedStepTree _fixedStepTree0;
 		FixedStepTree _fixedStepTree1;
 		
+		/** used to find an unblocked goal when the goal is inside an obstacle.
+		 *  Kept as a member so its point storage is reused between runs. */
+		FixedStepTree _goalTree;
+		
 		/** best goal point */
 		Geometry2d::Point _bestGoal;
 		
@@ -66,6 +74,10 @@ namespace Planning
 		///latest obstacles
 		const Geometry2d::CompositeShape* _obstacles;
 		
+		///state for this planner's random number generator.
+		///each planner has its own so several robots can plan at the same time.
+		unsigned short _randState[3];
+		
 		/** makes a path from the last point of each tree
 		 *  If the points don't match up...fail!
 		 *  The final path will be from the start of tree0
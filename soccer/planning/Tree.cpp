@@ -1,43 +1,42 @@
 #include "Tree.hpp"
 
 #include <Utils.hpp>
+#include <Constants.hpp>
 
 #include <stdio.h>
 #include <iostream>
+#include <algorithm>
 #include <boost/foreach.hpp>
 
 using namespace Planning;
 using namespace std;
 
 //// Point ////
-Tree::Point::Point(const Geometry2d::Point& p, Tree::Point* parent) :
+Tree::Point::Point(const Geometry2d::Point& p, int parent) :
 	pos(p)
 {
 	_parent = parent;
 	leaf = true;
-	
-	if (_parent)
-	{
-		_parent->children.push_back(this);
-		_parent->leaf = false;
-	}
-}
-
-void Tree::Point::addEdges(std::list<Geometry2d::Segment>& edges)
-{
-	BOOST_FOREACH(Tree::Point* next, children)
-	{
-		edges.push_back(Geometry2d::Segment(pos, next->pos));
-		next->addEdges(edges);
-	}
 }
 
 //// Tree ////
 
+/** side length of a nearest-neighbor grid cell in meters */
+static const float GridCellSize = 0.25f;
+
+/** number of grid cells along each axis of the floor */
+static const int GridCols = (int)(Floor_Width / GridCellSize) + 1;
+static const int GridRows = (int)(Floor_Length / GridCellSize) + 1;
+
+/** initial capacity of the point storage, it grows past this if needed */
+static const size_t InitialPointCapacity = 1024;
+
 Tree::Tree()
 {
 	step = .1;
 	_obstacles = 0;
+	_grid.resize(GridCols * GridRows);
+	points.reserve(InitialPointCapacity);
 }
 
 Tree::~Tree()
@@ -47,14 +46,16 @@ Tree::~Tree()
 
 void Tree::clear()
 {
-	 _obstacles = 0;
-
-    // Delete all points
-    BOOST_FOREACH(Point *pt, points)
-    {
-        delete pt;
-    }
-    points.clear();
+	_obstacles = 0;
+	
+	// Points are stored by value, so this just resets the size and keeps the storage
+	points.clear();
+	
+	BOOST_FOREACH(int cell, _usedCells)
+	{
+		_grid[cell].clear();
+	}
+	_usedCells.clear();
 }
 
 void Tree::init(const Geometry2d::Point& start, const Geometry2d::CompositeShape* obstacles)
@@ -63,9 +64,40 @@ void Tree::init(const Geometry2d::Point& start, const Geometry2d::CompositeShape
 	
 	_obstacles = obstacles;
 	
-	Point* p = new Point(start, 0);
+	Point* p = addPoint(start, -1);
 	_obstacles->hit(p->pos, p->hit);
-	points.push_back(p);
+}
+
+Tree::Point* Tree::addPoint(const Geometry2d::Point& pos, int parent)
+{
+	if (parent >= 0)
+	{
+		points[parent].leaf = false;
+	}
+	
+	points.push_back(Point(pos, parent));
+	const int index = points.size() - 1;
+	
+	int col, row;
+	gridCell(pos, col, row);
+	std::vector<int>& cell = _grid[row * GridCols + col];
+	if (cell.empty())
+	{
+		_usedCells.push_back(row * GridCols + col);
+	}
+	cell.push_back(index);
+	
+	return &points.back();
+}
+
+void Tree::gridCell(const Geometry2d::Point& pt, int& col, int& row) const
+{
+	// The floor spans x in [-Floor_Width/2, Floor_Width/2] and y in [-Field_Border, Field_Length + Field_Border]
+	col = (int)floorf((pt.x + Floor_Width / 2) / GridCellSize);
+	row = (int)floorf((pt.y + Field_Border) / GridCellSize);
+	
+	col = std::max(0, std::min(GridCols - 1, col));
+	row = std::max(0, std::min(GridRows - 1, row));
 }
 
 void Tree::addPath(Planning::Path &path, Point* dest, const bool rev)
@@ -83,7 +115,7 @@ void Tree::addPath(Planning::Path &path, Point* dest, const bool rev)
 		{
 			points.push_front(dest);
 		}
-		dest = dest->parent();
+		dest = parent(dest);
 		++n;
 	}
 	
@@ -94,42 +126,102 @@ void Tree::addPath(Planning::Path &path, Point* dest, const bool rev)
 	}
 }
 
+void Tree::addEdges(std::list<Geometry2d::Segment>& edges) const
+{
+	BOOST_FOREACH(const Point& pt, points)
+	{
+		if (pt.parent() >= 0)
+		{
+			edges.push_back(Geometry2d::Segment(points[pt.parent()].pos, pt.pos));
+		}
+	}
+}
+
+Tree::Point* Tree::parent(const Point* pt)
+{
+	if (!pt || pt->parent() < 0)
+	{
+		return 0;
+	}
+	
+	return &points[pt->parent()];
+}
+
 Tree::Point* Tree::nearest(Geometry2d::Point pt)
 {
+	int col, row;
+	gridCell(pt, col, row);
+	
 	float bestDistance = -1;
-    Point *best = 0;
-    
-    BOOST_FOREACH(Point* other, points)
-    {
-        float d = (other->pos - pt).magsq();
-        if (bestDistance < 0 || d < bestDistance)
-        {
-            bestDistance = d;
-            best = other;
-        }
-    }
-
-    return best;
+	Point *best = 0;
+	
+	// Search rings of cells around the cell containing pt, moving outwards.
+	// Every point in ring r is at least (r - 1) cells away from pt, so once that
+	// exceeds the best distance found so far no later ring can do better.
+	// Clamping off-floor points into edge cells only makes them farther than their
+	// cell suggests, so the bound still holds.
+	const int maxRing = std::max(GridCols, GridRows);
+	for (int r = 0; r <= maxRing; ++r)
+	{
+		if (best)
+		{
+			float ringDist = (r - 1) * GridCellSize;
+			if (ringDist > 0 && ringDist * ringDist > bestDistance)
+			{
+				break;
+			}
+		}
+		
+		for (int y = row - r; y <= row + r; ++y)
+		{
+			if (y < 0 || y >= GridRows)
+			{
+				continue;
+			}
+			
+			// Only the border of the ring is new, interior rows just need the two end cells
+			const int xStep = (y == row - r || y == row + r) ? 1 : std::max(1, 2 * r);
+			for (int x = col - r; x <= col + r; x += xStep)
+			{
+				if (x < 0 || x >= GridCols)
+				{
+					continue;
+				}
+				
+				BOOST_FOREACH(int i, _grid[y * GridCols + x])
+				{
+					float d = (points[i].pos - pt).magsq();
+					if (bestDistance < 0 || d < bestDistance)
+					{
+						bestDistance = d;
+						best = &points[i];
+					}
+				}
+			}
+		}
+	}
+	
+	return best;
 }
 
-Tree::Point* Tree::start() const
+Tree::Point* Tree::start()
 {
 	if (points.empty())
 	{
 		return 0;
 	}
 	
-	return points.front();
+	return &points.front();
 }
 
-Tree::Point* Tree::last() const
+Tree::Point* Tree::last()
 {
 	if (points.empty())
 	{
 		return 0;
 	}
 	
-	return points.back();
+	return &points.back();
 }
 
 //// Fixed Step Tree ////
@@ -163,26 +255,18 @@ Tree::Point* FixedStepTree::extend(Geometry2d::Point pt, Tree::Point* base)
 	// moveHit is the set of obstacles that this move touches.
 	// If this move touches any obstacles that the starting point didn't already touch,
 	// it has entered an obstacle and will be rejected.
-	std::set<shared_ptr<Geometry2d::Shape> > moveHit;
-	if (_obstacles->hit(Geometry2d::Segment(pos, base->pos), moveHit))
+	Geometry2d::CompositeShape::HitSet moveHit;
+	if (_obstacles->hit(Geometry2d::Segment(pos, base->pos), moveHit) &&
+		Geometry2d::CompositeShape::hitsNewObstacle(moveHit, base->hit))
 	{
-		// We only care if there are any items in moveHit that are not in point->hit, so
-		// we don't store the result of set_difference.
-		try
-		{
-			set_difference(moveHit.begin(), moveHit.end(), base->hit.begin(), 
-				base->hit.end(), ExceptionIterator<std::shared_ptr<Geometry2d::Shape>>());
-		} catch (exception& e)
-		{
-			// We hit a new obstacle
-			return 0;
-		}
+		// We hit a new obstacle
+		return 0;
 	}
 	
-	// Allow this point to be added to the tree
-	Point* p = new Point(pos, base);
+	// Allow this point to be added to the tree.
+	// This may move the existing points, so base can't be used after this.
+	Point* p = addPoint(pos, indexOf(base));
 	_obstacles->hit(p->pos, p->hit);
-	points.push_back(p);
 	
 	return p;
 }
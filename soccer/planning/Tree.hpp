@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <vector>
 
 #include <Geometry2d/Segment.hpp>
 #include <planning/Path.hpp>
@@ -8,7 +9,11 @@
 namespace Planning
 {
 	/** base tree class for rrt trees
-	 *  Tree can be grown in different ways */
+	 *  Tree can be grown in different ways
+	 *
+	 *  Points are stored by value in one contiguous vector that is reused between
+	 *  runs, so growing the tree doesn't allocate once the vector has warmed up.
+	 *  Because of this, a Point* is only valid until the next point is added. */
 	class Tree
 	{
 		public:
@@ -17,37 +22,37 @@ namespace Planning
 			class Point
 			{
 				public:
-					Point(const Geometry2d::Point& pos, Point* parent);
+					Point(const Geometry2d::Point& pos, int parent);
 					
 					//field position of the point
 					Geometry2d::Point pos;
 					
 					// Which obstacles contain this point
-					std::set<std::shared_ptr<Geometry2d::Shape>> hit;
+					Geometry2d::CompositeShape::HitSet hit;
 					
 					//velocity information (used by dynamic tree)
 					Geometry2d::Point vel;
 					
 					bool leaf;
 					
-					inline Point* parent() const { return _parent; }
-					
-					void addEdges(std::list<Geometry2d::Segment>& edges);
+					/** index of the parent point in the tree or -1 for the root */
+					inline int parent() const { return _parent; }
 					
 				private:
-					std::list<Point *> children;
-					Point* _parent;
+					int _parent;
 			};
 			
 			Tree();
 			virtual ~Tree();
 			
-			/** cleanup the tree */
+			/** cleanup the tree
+			 *  This keeps the storage so the next run can reuse it */
 			void clear();
 			
 			void init(const Geometry2d::Point &start, const Geometry2d::CompositeShape *obstacles);
 			
-			/** find the point of the tree closest to @a pt */
+			/** find the point of the tree closest to @a pt
+			 *  This uses the grid index so it doesn't need to look at every point */
 			Point* nearest(Geometry2d::Point pt);
 			
 			/** grow the tree in the direction of pt
@@ -62,19 +67,47 @@ namespace Planning
 			 *  If rev is true, the path will be from the dest point to its root */
 			void addPath(Planning::Path &path, Point* dest, const bool rev = false);
 			
+			/** adds a segment for every edge in the tree */
+			void addEdges(std::list<Geometry2d::Segment>& edges) const;
+			
+			/** returns the parent of @a pt or 0 if it is the root */
+			Point* parent(const Point* pt);
+			
 			/** returns the first point or 0 if none */
-			Point* start() const;
+			Point* start();
 			
 			/** last point added */
-			Point* last() const;
+			Point* last();
 			
 			/** tree step size...interpreted differently for different trees */
 			float step;
 			
-			std::list<Point*> points;
+			std::vector<Point> points;
 			
 		protected:
 			const Geometry2d::CompositeShape* _obstacles;
+			
+			/** adds a new point to the tree and the nearest-neighbor index.
+			 *  @a parent is the index of the parent point or -1 for the root */
+			Point* addPoint(const Geometry2d::Point& pos, int parent);
+			
+			/** index of a point in the tree */
+			int indexOf(const Point* pt) const
+			{
+				return pt - &points[0];
+			}
+			
+		private:
+			/** grid cell that contains @a pt.
+			 *  Points off the floor are clamped into the nearest edge cell. */
+			void gridCell(const Geometry2d::Point& pt, int& col, int& row) const;
+			
+			/** uniform grid over the floor, each cell holds the indices of the tree points inside it.
+			 *  Cells are cleared (not freed) between runs so their storage gets reused. */
+			std::vector<std::vector<int> > _grid;
+			
+			/** grid cells that have points in them, so clear() doesn't have to visit every cell */
+			std::vector<int> _usedCells;
 	};
 	
 	/** tree that grows based on fixed distance step */
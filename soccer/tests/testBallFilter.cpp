@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <modeling/BallFilter.hpp>
+#include <modeling/BallTracker.hpp>
+#include <SystemState.hpp>
+
+using namespace Geometry2d;
+
+// Time between vision frames
+static const uint64_t Frame_us = 1000000 / 60;
+
+// Feeds the filter observations of a ball following @path from @start for @frames frames.
+// Returns the time of the last observation.
+static uint64_t observe(BallFilter &filter, const BallTrajectory &path, uint64_t start, int frames)
+{
+	uint64_t t = start;
+	for (int i = 0; i < frames; ++i)
+	{
+		t = start + i * Frame_us;
+		BallObservation obs(path.pos((t - start) / 1000000.0f), t);
+		filter.update(&obs);
+	}
+	return t;
+}
+
+TEST(BallFilter, tracksRollingBall) {
+	BallFilter filter;
+	observe(filter, BallTrajectory(Point(0, 1), Point(1, 0)), Frame_us, 60);
+
+	Ball ball;
+	filter.predict(60 * Frame_us, &ball, nullptr);
+	EXPECT_TRUE(ball.valid);
+	EXPECT_FALSE(filter.kicked());
+	EXPECT_NEAR(1 - Ball_RollingDecel, ball.vel.x, 0.1);
+	EXPECT_NEAR(0, ball.vel.y, 0.1);
+}
+
+TEST(BallFilter, kickIsPickedUp) {
+	BallFilter filter;
+
+	// Roll at 1 m/s for a second
+	BallTrajectory rolling(Point(0, 1), Point(1, 0));
+	uint64_t last = observe(filter, rolling, Frame_us, 60);
+	ASSERT_FALSE(filter.kicked());
+
+	// Kick to 5 m/s halfway between frames
+	float kickTime = (last - Frame_us + Frame_us / 2) / 1000000.0f;
+	BallTrajectory kicked(rolling.pos(kickTime), Point(5, 0), Ball_RollingSpeedFraction * 5);
+
+	Ball ball;
+	for (int i = 1; i <= 5; ++i)
+	{
+		uint64_t t = last + i * Frame_us;
+		float sinceKick = (t - Frame_us) / 1000000.0f - kickTime;
+		BallObservation obs(kicked.pos(sinceKick), t);
+		filter.update(&obs);
+		filter.predict(t, &ball, nullptr);
+
+		// One observation only shows that the ball jumped ahead.  The second shows it kept going.
+		if (i >= 2)
+		{
+			EXPECT_TRUE(filter.kicked()) << "frame " << i;
+			EXPECT_GT(ball.vel.x, 3) << "frame " << i;
+		}
+		EXPECT_LE(filter.numHypotheses(), 4);
+	}
+
+	float sinceKick = (last + 5 * Frame_us - Frame_us) / 1000000.0f - kickTime;
+	EXPECT_NEAR(kicked.vel(sinceKick).x, ball.vel.x, 0.75);
+	EXPECT_NEAR(0, ball.vel.y, 0.1);
+}
+
+TEST(BallFilter, hypothesesArePruned) {
+	BallFilter filter;
+	observe(filter, BallTrajectory(Point(), Point()), Frame_us, 100);
+
+	// A still ball never needs more than the most likely hypothesis and a few kick guesses
+	EXPECT_GE(filter.numHypotheses(), 1);
+	EXPECT_LE(filter.numHypotheses(), 4);
+	EXPECT_FALSE(filter.kicked());
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <modeling/BallTrajectory.hpp>
+#include <Constants.hpp>
+#include <math.h>
+
+using namespace Geometry2d;
+
+TEST(BallTrajectory, rollsToAStop) {
+	BallTrajectory path(Point(1, 0), Point(0, 2));
+
+	float stop = 2 / Ball_RollingDecel;
+	EXPECT_NEAR(stop, path.stopTime(), 0.001);
+	EXPECT_NEAR(2 * stop / 2, path.stopDistance(), 0.001);
+
+	// Doesn't move backwards after stopping
+	EXPECT_NEAR(path.stopDistance(), path.pos(stop + 10).y, 0.001);
+	EXPECT_FLOAT_EQ(1, path.pos(stop + 10).x);
+	EXPECT_FLOAT_EQ(0, path.vel(stop + 10).mag());
+}
+
+TEST(BallTrajectory, slidesThenRolls) {
+	BallTrajectory path(Point(), Point(4, 0), 3);
+
+	// Sliding decelerates faster
+	float slideTime = 1 / Ball_SlidingDecel;
+	EXPECT_NEAR(3, path.vel(slideTime).x, 0.001);
+	EXPECT_NEAR(3 - Ball_RollingDecel, path.vel(slideTime + 1).x, 0.001);
+	EXPECT_NEAR(slideTime + 3 / Ball_RollingDecel, path.stopTime(), 0.001);
+}
+
+TEST(BallTrajectory, timeToReachInvertsDistance) {
+	BallTrajectory path(Point(), Point(3, 0), 2);
+
+	for (float t = 0; t < path.stopTime(); t += 0.25)
+	{
+		EXPECT_NEAR(t, path.timeToReach(path.distance(t)), 0.01);
+	}
+
+	EXPECT_TRUE(isinf(path.timeToReach(path.stopDistance() + 0.1)));
+	EXPECT_TRUE(isinf(BallTrajectory().timeToReach(0.1)));
+}
+
+TEST(BallTrajectory, interceptMeetsBall) {
+	BallTrajectory path(Point(), Point(2, 0));
+
+	// A robot standing on the ball's path gets to the ball no later than if it waited,
+	// and can actually get there in time
+	Point where;
+	float t = path.interceptTime(Point(1, 0), 3, 4, &where);
+	EXPECT_LE(t, path.timeToReach(1));
+	EXPECT_NEAR(path.pos(t).x, where.x, 0.001);
+	EXPECT_LE(BallTrajectory::travelTime((where - Point(1, 0)).mag(), 3, 4), t);
+
+	// A slow robot far away meets the ball where it stops
+	t = path.interceptTime(Point(0, 20), 0.5, 1, &where);
+	EXPECT_NEAR(path.stopDistance(), where.x, 0.001);
+	EXPECT_FLOAT_EQ(BallTrajectory::travelTime((where - Point(0, 20)).mag(), 0.5, 1), t);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <Geometry2d/CompositeShape.hpp>
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/Polygon.hpp>
+#include <Geometry2d/Rect.hpp>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Geometry2d;
+
+/* ************************************************************************* */
+// The bounding box check must never change the result of hit()
+TEST( testCompositeShape, broadphaseMatchesExactTests ) {
+	CompositeShape obstacles;
+	obstacles.add(std::shared_ptr<Shape>(new Circle(Point(0, 2), 0.5)));
+	obstacles.add(std::shared_ptr<Shape>(new Circle(Point(-1, 4), 0.09)));
+	obstacles.add(std::shared_ptr<Shape>(new Polygon(Segment(Point(1, 1), Point(2, 3)), 0.2)));
+	obstacles.add(std::shared_ptr<Shape>(new Rect(Point(-2, 0), Point(-1.5, 1))));
+
+	CompositeShape inner;
+	inner.add(std::shared_ptr<Shape>(new Circle(Point(1.5, 5), 0.3)));
+	obstacles.add(std::shared_ptr<Shape>(inner.clone()));
+
+	srand48(1);
+	for (int i = 0; i < 2000; ++i)
+	{
+		Point a(6 * drand48() - 3, 7 * drand48() - 0.5);
+		Point b = a + Point(drand48() - 0.5, drand48() - 0.5);
+		Segment seg(a, b);
+
+		CompositeShape::HitSet pointHits, segHits;
+		obstacles.hit(a, pointHits);
+		obstacles.hit(seg, segHits);
+
+		for (unsigned int j = 0; j < obstacles.size(); ++j)
+		{
+			EXPECT_EQ(obstacles[j]->hit(a), pointHits.test(j));
+			EXPECT_EQ(obstacles[j]->hit(seg), segHits.test(j));
+		}
+
+		EXPECT_EQ(pointHits.any(), obstacles.hit(a));
+		EXPECT_EQ(segHits.any(), obstacles.hit(seg));
+	}
+}
+
+/* ************************************************************************* */
+// Subshapes past the inline bits of a HitSet must still be told apart
+TEST( testCompositeShape, manySubshapesHaveTheirOwnBits ) {
+	CompositeShape obstacles;
+	for (int i = 0; i < 300; ++i)
+	{
+		obstacles.add(std::shared_ptr<Shape>(new Circle(Point(i, 0), 0.1)));
+	}
+
+	CompositeShape::HitSet oldHits;
+	EXPECT_TRUE(obstacles.hit(Point(200, 0), oldHits));
+	EXPECT_TRUE(oldHits.test(200));
+	EXPECT_FALSE(oldHits.test(299));
+
+	// Moving into obstacle 299 while already in 200 hits a new obstacle
+	CompositeShape::HitSet newHits;
+	EXPECT_TRUE(obstacles.hit(Segment(Point(200, 0), Point(200, 0.05)), newHits));
+	EXPECT_FALSE(CompositeShape::hitsNewObstacle(newHits, oldHits));
+	newHits.set(299);
+	EXPECT_TRUE(CompositeShape::hitsNewObstacle(newHits, oldHits));
+	EXPECT_FALSE(CompositeShape::hitsNewObstacle(oldHits, newHits));
+}
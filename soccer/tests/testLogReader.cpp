@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <LogReader.hpp>
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Packet;
+
+// Writes @n frames in Logger's format, followed by @tornBytes bytes of a partial record.
+static void writeLog(const char *filename, int n, int tornBytes = 0)
+{
+	FILE *fp = fopen(filename, "wb");
+	ASSERT_TRUE(fp != 0);
+	for (int i = 0; i < n; ++i)
+	{
+		LogFrame frame;
+		frame.set_command_time(1000 * i);
+		string buf = frame.SerializePartialAsString();
+		uint32_t size = buf.size();
+		fwrite(&size, sizeof(size), 1, fp);
+		fwrite(buf.data(), buf.size(), 1, fp);
+	}
+	
+	if (tornBytes)
+	{
+		uint32_t size = 100;
+		fwrite(&size, sizeof(size), 1, fp);
+		string junk(tornBytes, 0);
+		fwrite(junk.data(), junk.size(), 1, fp);
+	}
+	fclose(fp);
+}
+
+TEST(LogReader, randomAccessWithIndexCache) {
+	const char *filename = "/tmp/testLogReader.log";
+	unlink(LogReader::indexFilename(filename).toAscii());
+	writeLog(filename, 50, 10);
+	
+	LogReader reader(8);
+	ASSERT_TRUE(reader.open(filename));
+	EXPECT_FALSE(reader.indexFromCache());
+	EXPECT_EQ(50, reader.numFrames());
+	
+	EXPECT_EQ(49000, reader.frame(49)->command_time());
+	EXPECT_EQ(0, reader.frame(0)->command_time());
+	for (int i = 0; i < 50; ++i)
+	{
+		EXPECT_EQ(1000 * i, reader.frame(i)->command_time());
+	}
+	EXPECT_FALSE(reader.frame(50));
+	
+	// The second open uses the saved index
+	ASSERT_TRUE(reader.open(filename));
+	EXPECT_TRUE(reader.indexFromCache());
+	EXPECT_EQ(50, reader.numFrames());
+	EXPECT_EQ(25000, reader.frame(25)->command_time());
+	
+	unlink(filename);
+	unlink(LogReader::indexFilename(filename).toAscii());
+}
+
+TEST(LogReader, badIndexIsRebuilt) {
+	const char *filename = "/tmp/testLogReaderBadIndex.log";
+	QString indexFilename = LogReader::indexFilename(filename);
+	unlink(indexFilename.toAscii());
+	writeLog(filename, 50);
+	
+	LogReader reader;
+	ASSERT_TRUE(reader.open(filename));
+	reader.close();
+	
+	// Point the last offset past the end of the log.
+	// The header is magic, version, size, mtime and count.
+	FILE *fp = fopen(indexFilename.toAscii(), "r+b");
+	ASSERT_TRUE(fp != 0);
+	uint64_t offset = 1 << 30;
+	fseek(fp, 8 + 4 + 8 + 8 + 8 + 49 * sizeof(offset), SEEK_SET);
+	fwrite(&offset, sizeof(offset), 1, fp);
+	fclose(fp);
+	
+	ASSERT_TRUE(reader.open(filename));
+	EXPECT_FALSE(reader.indexFromCache());
+	EXPECT_EQ(50, reader.numFrames());
+	EXPECT_EQ(49000, reader.frame(49)->command_time());
+	
+	unlink(filename);
+	unlink(indexFilename.toAscii());
+}
+
+TEST(LogReader, chunkedLogRecovery) {
+	const char *filename = "/tmp/testLogReaderChunked.log";
+	int fd = creat(filename, 0666);
+	ASSERT_GE(fd, 0);
+	
+	// Small chunks so the log has several
+	ChunkedLog::Writer writer(1 << 20, 16);
+	ASSERT_TRUE(writer.open(fd));
+	for (int i = 0; i < 100; ++i)
+	{
+		LogFrame frame;
+		frame.set_command_time(1000 * i);
+		frame.ByteSize();
+		ASSERT_TRUE(writer.addFrame(frame));
+	}
+	ASSERT_TRUE(writer.close());
+	
+	LogReader reader;
+	ASSERT_TRUE(reader.open(filename));
+	EXPECT_TRUE(reader.chunked());
+	EXPECT_FALSE(reader.recovered());
+	EXPECT_EQ(100, reader.numFrames());
+	EXPECT_EQ(99000, reader.frame(99)->command_time());
+	EXPECT_EQ(17000, reader.frame(17)->command_time());
+	EXPECT_EQ(3000, reader.frame(3)->command_time());
+	
+	// Cut off the index and part of the last chunk, as if soccer crashed while writing it
+	struct stat st;
+	ASSERT_EQ(0, stat(filename, &st));
+	reader.close();
+	ASSERT_EQ(0, truncate(filename, st.st_size - 300));
+	
+	ASSERT_TRUE(reader.open(filename));
+	EXPECT_TRUE(reader.recovered());
+	EXPECT_EQ(96, reader.numFrames());
+	EXPECT_EQ(95000, reader.frame(95)->command_time());
+	
+	close(fd);
+	unlink(filename);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <Logger.hpp>
+#include <LogReader.hpp>
+
+#include <unistd.h>
+
+using namespace std;
+using namespace Packet;
+
+// Makes a frame with a known time and about @padding bytes of debug text
+static shared_ptr<LogFrame> makeFrame(uint64_t time, int padding)
+{
+	shared_ptr<LogFrame> frame = make_shared<LogFrame>();
+	frame->set_command_time(time);
+	frame->add_debug_layers(string(padding, 'x'));
+	return frame;
+}
+
+TEST(Logger, historyFitsBudget) {
+	const size_t Budget = 100 * 1000;
+	Logger logger(Budget);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		logger.addFrame(makeFrame(i, 1000));
+		ASSERT_LE(logger.spaceUsed(), Budget);
+	}
+
+	// About 1000 bytes per frame, so about 100 frames fit
+	EXPECT_GT(logger.numFrames(), 90);
+	EXPECT_LT(logger.numFrames(), 100);
+	EXPECT_EQ(999, logger.lastFrameNumber());
+	EXPECT_EQ(1000 - logger.numFrames(), logger.firstFrameNumber());
+	EXPECT_EQ(999u, logger.lastFrame()->command_time());
+
+	vector<shared_ptr<LogFrame> > frames(3);
+	EXPECT_EQ(0, logger.getFrames(logger.firstFrameNumber() - 1, frames));
+	EXPECT_EQ(3, logger.getFrames(999, frames));
+	EXPECT_EQ(999u, frames[0]->command_time());
+	EXPECT_EQ(997u, frames[2]->command_time());
+}
+
+TEST(Logger, spilledFramesAreParsed) {
+	Logger logger(10 * 1000, 50 * 1000);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		logger.addFrame(makeFrame(i, 1000));
+	}
+	EXPECT_LE(logger.spaceUsed(), logger.budget());
+
+	// Read across the boundary between spilled and live frames
+	int first = logger.firstFrameNumber();
+	vector<shared_ptr<LogFrame> > frames(logger.numFrames());
+	ASSERT_EQ((int)frames.size(), logger.getFrames(logger.lastFrameNumber(), frames));
+	for (unsigned int i = 0; i < frames.size(); ++i)
+	{
+		ASSERT_TRUE(frames[i] != nullptr);
+		EXPECT_EQ((uint64_t)(999 - i), frames[i]->command_time());
+	}
+	EXPECT_EQ((uint64_t)first, frames.back()->command_time());
+	EXPECT_GT(logger.numFrames(), 50);
+}
+
+TEST(Logger, writtenFramesAreRead) {
+	const char *filename = "/tmp/testLogger.log";
+	unlink(LogReader::indexFilename(filename).toAscii());
+	
+	// Fewer frames than the write queue holds, so none are dropped
+	const int N = 500;
+	Logger logger;
+	ASSERT_TRUE(logger.open(filename));
+	for (int i = 0; i < N; ++i)
+	{
+		logger.addFrame(makeFrame(1000 * i, 100));
+	}
+	logger.close();
+	
+	Logger::WriteStats stats = logger.writeStats();
+	EXPECT_EQ((uint64_t)N, stats.framesWritten);
+	EXPECT_EQ(0u, stats.framesDropped);
+	EXPECT_EQ(0, stats.queueDepth);
+	
+	LogReader reader;
+	ASSERT_TRUE(reader.open(filename));
+	EXPECT_FALSE(reader.recovered());
+	ASSERT_EQ(N, reader.numFrames());
+	for (int i = 0; i < N; ++i)
+	{
+		shared_ptr<LogFrame> frame = reader.frame(i);
+		ASSERT_TRUE(frame != nullptr);
+		EXPECT_EQ((uint64_t)(1000 * i), frame->command_time());
+	}
+	reader.close();
+	
+	unlink(filename);
+	unlink(LogReader::indexFilename(filename).toAscii());
+}
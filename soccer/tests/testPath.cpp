@@ -1,6 +1,7 @@
 #include <iostream>
 #include <gtest/gtest.h>
 #include <planning/Path.hpp>
+#include <Geometry2d/Circle.hpp>
 
 using namespace std;
 using namespace Geometry2d;
@@ -115,3 +116,18 @@ TEST(Path, evaluate) {
 	EXPECT_FALSE(pathValid);
 }
 
+
+/* ************************************************************************* */
+TEST( testPath, hitOnlyCountsNewObstacles ) {
+	CompositeShape obstacles;
+	obstacles.add(std::shared_ptr<Shape>(new Circle(Point(0, 0), 0.5)));
+
+	// starts inside an obstacle and leaves it
+	Planning::Path path(Point(0, 0), Point(0, 1));
+	EXPECT_FALSE(path.hit(obstacles));
+
+	// now enters a second obstacle on the way out
+	obstacles.add(std::shared_ptr<Shape>(new Circle(Point(0, 1.5), 0.2)));
+	path.points.push_back(Point(0, 2));
+	EXPECT_TRUE(path.hit(obstacles));
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <modeling/RobotFilter.hpp>
+
+// Observation of a robot moving at constant velocity, seen by alternating cameras
+static RobotObservation movingObservation(int i, float vx)
+{
+	uint64_t time = 1000000 + i * 16667;
+	float t = i * 0.016667f;
+	RobotObservation obs(Geometry2d::Point(vx * t, 1), 0.5, time, i);
+	obs.source = i % 2;
+	return obs;
+}
+
+TEST(RobotFilter, tracksVelocityAcrossCameras) {
+	RobotFilter filter;
+	RobotPose robot;
+
+	for (int i = 0; i < 60; ++i)
+	{
+		RobotObservation obs = movingObservation(i, 1.5);
+		filter.update(&obs);
+	}
+
+	// Predict a tenth of a second past the last observation
+	uint64_t time = movingObservation(59, 1.5).time + 100000;
+	filter.predict(time, &robot);
+
+	EXPECT_TRUE(robot.visible);
+	EXPECT_NEAR(1.5, robot.vel.x, 0.05);
+	EXPECT_NEAR(0, robot.vel.y, 0.05);
+	EXPECT_NEAR(1.5 * (59 * 0.016667f + 0.1f), robot.pos.x, 0.02);
+	EXPECT_NEAR(1, robot.pos.y, 0.02);
+	EXPECT_NEAR(0.5, robot.angle, 0.02);
+}
+
+TEST(RobotFilter, coastsThenLosesRobot) {
+	RobotFilter filter;
+	RobotPose robot;
+
+	filter.predict(1000000, &robot);
+	EXPECT_FALSE(robot.visible);
+
+	RobotObservation obs(Geometry2d::Point(1, 2), 0, 1000000, 0);
+	obs.source = 0;
+	filter.update(&obs);
+
+	filter.predict(1200000, &robot);
+	EXPECT_TRUE(robot.visible);
+
+	filter.predict(3000000, &robot);
+	EXPECT_FALSE(robot.visible);
+}
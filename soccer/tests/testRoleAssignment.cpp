@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <gameplay/RoleAssignment.hpp>
+
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace std;
+using namespace Geometry2d;
+using namespace Gameplay;
+
+// Smallest total cost over every way of giving each row a different column
+static double bruteForce(const vector<double> &costs, int rows, int cols)
+{
+	vector<int> perm(cols);
+	for (int j = 0; j < cols; ++j)
+	{
+		perm[j] = j;
+	}
+
+	double best = 1e30;
+	do
+	{
+		double total = 0;
+		for (int i = 0; i < rows; ++i)
+		{
+			total += costs[i * cols + perm[i]];
+		}
+		best = min(best, total);
+	} while (next_permutation(perm.begin(), perm.end()));
+	return best;
+}
+
+TEST(RoleAssignment, warmStartStaysOptimal) {
+	srand(1);
+	RoleAssignment solver;
+	const int cols = 6;
+	vector<int> shells;
+	for (int j = 0; j < cols; ++j)
+	{
+		shells.push_back(j);
+	}
+
+	// Costs drift a little each frame and the number of roles changes, like in a game
+	vector<double> costs(cols * cols);
+	for (unsigned int k = 0; k < costs.size(); ++k)
+	{
+		costs[k] = rand() % 1000 / 100.0;
+	}
+
+	for (int frame = 0; frame < 200; ++frame)
+	{
+		int rows = 1 + frame / 10 % cols;
+		for (unsigned int k = 0; k < costs.size(); ++k)
+		{
+			costs[k] = max(0.0, costs[k] + (rand() % 100 - 50) / 100.0);
+		}
+
+		vector<int> assignment;
+		double total = solver.solve(costs, rows, cols, shells, assignment);
+
+		ASSERT_EQ(rows, (int)assignment.size());
+		vector<bool> taken(cols, false);
+		double check = 0;
+		for (int i = 0; i < rows; ++i)
+		{
+			ASSERT_GE(assignment[i], 0);
+			ASSERT_FALSE(taken[assignment[i]]);
+			taken[assignment[i]] = true;
+			check += costs[i * cols + assignment[i]];
+		}
+		EXPECT_NEAR(check, total, 1e-9);
+		EXPECT_NEAR(bruteForce(costs, rows, cols), total, 1e-9);
+	}
+}
+
+TEST(RoleAssignment, requirements) {
+	RoleAssignment solver;
+
+	vector<RoleCandidate> candidates(2);
+	candidates[0].shell = 1;
+	candidates[0].pos = Point(1, 6);
+	candidates[1].shell = 2;
+	candidates[1].pos = Point(2, 3);
+	candidates[1].hasBall = true;
+
+	vector<RoleRequirement> reqs(2);
+	reqs[0].hasDestination = true;
+	reqs[0].destination = Segment(Point(2, 3), Point(2, 3));
+	reqs[1].hasDestination = true;
+	reqs[1].destination = Segment(Point(1, 7), Point(1, 7));
+
+	vector<int> assignment;
+	ASSERT_TRUE(solver.assign(candidates, reqs, assignment));
+	EXPECT_EQ(1, assignment[0]);
+	EXPECT_EQ(0, assignment[1]);
+
+	// Having the ball outweighs distance
+	reqs[1].hasBall = true;
+	ASSERT_TRUE(solver.assign(candidates, reqs, assignment));
+	EXPECT_EQ(0, assignment[0]);
+	EXPECT_EQ(1, assignment[1]);
+
+	// Nobody can kick
+	reqs[0].requireKicking = true;
+	EXPECT_FALSE(solver.assign(candidates, reqs, assignment));
+
+	// More roles than robots
+	reqs.resize(3);
+	EXPECT_FALSE(solver.assign(candidates, reqs, assignment));
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <planning/Tree.hpp>
+#include <planning/RRTPlanner.hpp>
+#include <Geometry2d/Circle.hpp>
+
+using namespace std;
+using namespace Geometry2d;
+using namespace Planning;
+
+/* ************************************************************************* */
+TEST( testTree, nearestMatchesLinearScan ) {
+	CompositeShape obstacles;
+	obstacles.add(std::shared_ptr<Shape>(new Circle(Geometry2d::Point(0, 2), 0.5)));
+
+	FixedStepTree tree;
+	tree.init(Geometry2d::Point(0, 0.5), &obstacles);
+	tree.step = 0.15;
+
+	srand48(1);
+	for (int i = 0; i < 500; ++i)
+	{
+		Geometry2d::Point r = randomPoint();
+
+		// every few queries use a point off the floor to exercise edge clamping
+		if (i % 5 == 0)
+		{
+			r = Geometry2d::Point(10 * (drand48() - 0.5), 12 * (drand48() - 0.3));
+		}
+
+		float best = -1;
+		for (const Tree::Point& p : tree.points)
+		{
+			float d = (p.pos - r).magsq();
+			if (best < 0 || d < best)
+			{
+				best = d;
+			}
+		}
+
+		Tree::Point* nearest = tree.nearest(r);
+		ASSERT_TRUE(nearest != nullptr);
+		EXPECT_FLOAT_EQ(best, (nearest->pos - r).magsq());
+
+		tree.extend(r);
+	}
+}
+
+/* ************************************************************************* */
+TEST( testTree, parentsSurviveGrowth ) {
+	CompositeShape obstacles;
+
+	FixedStepTree tree;
+	tree.init(Geometry2d::Point(0, 0), &obstacles);
+	tree.step = 0.001;
+
+	// grow well past the initial capacity so the point storage has to move
+	for (int i = 0; i < 3000; ++i)
+	{
+		ASSERT_TRUE(tree.extend(Geometry2d::Point(0, 4)) != nullptr);
+	}
+
+	Planning::Path path;
+	tree.addPath(path, tree.last());
+	ASSERT_EQ(3001, path.size());
+	EXPECT_TRUE(path.points.front() == Geometry2d::Point(0, 0));
+	EXPECT_NEAR(3000 * 0.001, path.length(), 1e-3);
+}
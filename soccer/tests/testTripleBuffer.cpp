@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <TripleBuffer.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(TripleBuffer, readerSeesWholeValues) {
+	TripleBuffer<vector<int> > buffer;
+	const int Count = 100000;
+	const int Size = 64;
+
+	thread writer([&]()
+	{
+		for (int i = 1; i <= Count; ++i)
+		{
+			buffer.back().assign(Size, i);
+			buffer.publish();
+		}
+	});
+
+	// Every value read must be one the writer published in full, and values never go backwards
+	int last = 0;
+	while (last < Count)
+	{
+		const vector<int> &v = buffer.read();
+		if (v.empty())
+		{
+			continue;
+		}
+
+		ASSERT_EQ(Size, (int)v.size());
+		for (int j = 1; j < Size; ++j)
+		{
+			ASSERT_EQ(v[0], v[j]);
+		}
+		ASSERT_GE(v[0], last);
+		last = v[0];
+	}
+
+	writer.join();
+}
@@ -0,0 +1,14 @@
+#include <gtest/gtest.h>
+#include <Utils.hpp>
+
+TEST(Utils, simulatedClockDrivesTimestamp) {
+	SimulatedClock clock(1000);
+	setTimeSource(&clock);
+	EXPECT_EQ(1000, timestamp());
+
+	clock.advance(16667);
+	EXPECT_EQ(17667, timestamp());
+
+	setTimeSource(0);
+	EXPECT_GT(timestamp(), 17667);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <gameplay/WindowEvaluator.hpp>
+#include <Constants.hpp>
+
+using namespace std;
+using namespace Geometry2d;
+using namespace Gameplay;
+
+static const Segment TheirGoal(Point(Field_GoalWidth / 2, Field_Length), Point(-Field_GoalWidth / 2, Field_Length));
+
+TEST(WindowEvaluator, robotSplitsWindow) {
+	WindowEvaluator winEval;
+	// An opponent sitting right in front of their goal
+	winEval.obstacles.push_back(Point(0, Field_Length - Robot_Radius * 1.5));
+
+	vector<Window> windows;
+	int best = winEval.evaluate(Point(0, Field_Length / 2), TheirGoal, windows);
+
+	ASSERT_EQ(2, windows.size());
+	ASSERT_GE(best, 0);
+	EXPECT_LT(windows[0].t1, windows[1].t0);
+	EXPECT_FLOAT_EQ(0, windows[0].t0);
+	EXPECT_FLOAT_EQ(TheirGoal.delta().magsq(), windows[1].t1);
+}
+
+TEST(WindowEvaluator, batchMatchesSingle) {
+	WindowEvaluator winEval;
+	winEval.obstacles.push_back(Point(0.1, Field_Length - 1));
+	winEval.obstacles.push_back(Point(-1, 2));
+
+	vector<Point> origins;
+	for (int i = 0; i < 10; ++i)
+	{
+		origins.push_back(Point(i * 0.3 - 1.5, 2.5));
+	}
+	// Right behind a robot, which blocks the whole goal
+	origins.push_back(Point(0.1, Field_Length - 1 - Robot_Radius - Ball_Radius));
+
+	vector<Window> best;
+	vector<bool> found;
+	winEval.evaluateBest(origins, TheirGoal, best, found);
+	ASSERT_EQ(origins.size(), best.size());
+
+	for (unsigned int i = 0; i < origins.size(); ++i)
+	{
+		vector<Window> windows;
+		int b = winEval.evaluate(origins[i], TheirGoal, windows);
+		ASSERT_EQ(b >= 0, found[i]);
+		if (found[i])
+		{
+			EXPECT_FLOAT_EQ(windows[b].t0, best[i].t0);
+			EXPECT_FLOAT_EQ(windows[b].t1, best[i].t1);
+		}
+	}
+}